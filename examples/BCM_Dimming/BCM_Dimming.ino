@@ -0,0 +1,69 @@
+/*
+  LED_BUILTIN.h - Gradation BCM (Binary Code Modulation) sur GPIO simples
+  
+  ============================================================================
+  8 LED d'état à luminosité réglable sur des GPIO ordinaires, sans canal
+  PWM matériel (ESP8266) ni canal LEDC (ESP32). Une interruption timer
+  affiche successivement les LED_BCM_BITS plans de bits : son coût dépend
+  du nombre de bits, pas du nombre de LED.
+  
+  Les animations blink / pattern fonctionnent comme d'habitude : une LED
+  allumée prend la luminosité fixée par LED_CHANNEL_SET_BRIGHTNESS().
+  
+  Broches : premier banc GPIO uniquement (0-31 sur ESP32, 0-15 sur ESP8266).
+  ============================================================================
+*/
+
+// Options du moteur (build_flags de platformio.ini ou LED_BUILTIN_config.h) :
+//   -D LED_CHANNEL_COUNT=9           ; LED_BUILTIN + 8 LED gradables
+//   -D LED_BUILTIN_BACKEND_BCM
+//   -D LED_BCM_BITS=8                ; optionnel (défaut : 8)
+
+#include <Arduino.h>
+#include "LED_BUILTIN.h"
+
+#if LED_CHANNEL_COUNT != 9 || !defined(LED_BUILTIN_BACKEND_BCM)
+  #error "Build with -D LED_CHANNEL_COUNT=9 -D LED_BUILTIN_BACKEND_BCM"
+#endif
+
+#if defined(ESP8266)
+  // GPIO 2 = LED_BUILTIN (canal 0), GPIO 1 = TX : GPIO 3 (RX) n'est libre
+  // que parce que Serial est ouvert en émission seule dans setup()
+  static const uint8_t bcmPins[LED_CHANNEL_COUNT - 1] = {5, 4, 0, 14, 12, 13, 15, 3};
+#else
+  static const uint8_t bcmPins[LED_CHANNEL_COUNT - 1] = {16, 17, 18, 19, 21, 22, 23, 25};
+#endif
+
+void setup() {
+#if defined(ESP8266)
+  Serial.begin(115200, SERIAL_8N1, SERIAL_TX_ONLY);
+#else
+  Serial.begin(115200);
+#endif
+  delay(100);
+  
+  ENABLE_LED_BUILTIN();
+  if(!LED_BCM_BEGIN(bcmPins, 100)) {
+    Serial.println("Erreur : broche hors du premier banc GPIO ou timer indisponible");
+  }
+  
+  // Dégradé de luminosité fixe : de 1/128 à pleine intensité
+  for(uint16_t ch = 1; ch < LED_CHANNEL_COUNT; ch++) {
+    LED_CHANNEL_SET_BRIGHTNESS(ch, (uint8_t)((1 << ch) - 1));
+    LED_CHANNEL_ON(ch);
+  }
+}
+
+void loop() {
+  LED_BUILTIN_UPDATE();
+  
+  // Après 5 s : clignotement lent à mi-luminosité sur les LED paires
+  static bool blinking = false;
+  if(!blinking && millis() > 5000) {
+    blinking = true;
+    for(uint16_t ch = 2; ch < LED_CHANNEL_COUNT; ch += 2) {
+      LED_CHANNEL_SET_BRIGHTNESS(ch, 64);
+      LED_CHANNEL_BLINK_START(ch, 500, 500, 255);
+    }
+  }
+}
@@ -0,0 +1,86 @@
+/*
+  LED_BUILTIN.h - Benchmark du chemin critique de LED_BUILTIN_UPDATE()
+  
+  ============================================================================
+  Mesure, en cycles CPU, le coût moyen d'un appel à LED_BUILTIN_UPDATE() :
+    1. au repos (aucune animation)
+    2. animation en cours mais aucune transition échue
+  Le coût de la boucle de mesure elle-même est soustrait.
+  ============================================================================
+  
+  Résultat attendu : quelques cycles par appel dans les deux cas, millis()
+  n'étant lu qu'à l'échéance d'une transition.
+*/
+
+#include <Arduino.h>
+#include "LED_BUILTIN.h"
+
+static const uint32_t ITERATIONS = 100000;
+
+// ============================================================================
+// MESURE
+// ============================================================================
+static uint32_t measureEmptyLoop() {
+  uint32_t start = ESP.getCycleCount();
+  for(uint32_t i = 0; i < ITERATIONS; i++) {
+    __asm__ __volatile__("" ::: "memory");
+  }
+  return ESP.getCycleCount() - start;
+}
+
+static uint32_t measureUpdate() {
+  uint32_t start = ESP.getCycleCount();
+  for(uint32_t i = 0; i < ITERATIONS; i++) {
+    LED_BUILTIN_UPDATE();
+    __asm__ __volatile__("" ::: "memory");
+  }
+  return ESP.getCycleCount() - start;
+}
+
+static void report(const char* label, uint32_t cycles, uint32_t overhead) {
+  uint32_t net = cycles > overhead ? cycles - overhead : 0;
+  Serial.print(label);
+  Serial.print(" : ");
+  Serial.print((float)net / ITERATIONS, 2);
+  Serial.print(" cycles/appel (");
+  Serial.print((float)net / ITERATIONS / ESP.getCpuFreqMHz() * 1000.0f, 1);
+  Serial.println(" ns)");
+}
+
+// ============================================================================
+// SETUP
+// ============================================================================
+void setup() {
+  Serial.begin(115200);
+  delay(100);
+  
+  Serial.println("\n\n========================================");
+  Serial.println("  LED_BUILTIN - Benchmark UPDATE()");
+  Serial.println("========================================\n");
+  
+  ENABLE_LED_BUILTIN();
+  
+  Serial.print("CPU : ");
+  Serial.print(ESP.getCpuFreqMHz());
+  Serial.print(" MHz, ");
+  Serial.print(ITERATIONS);
+  Serial.println(" appels par mesure\n");
+  
+  uint32_t overhead = measureEmptyLoop();
+  
+  // 1. Au repos
+  LED_BUILTIN_STOP();
+  report("Repos          ", measureUpdate(), overhead);
+  
+  // 2. Animation active, prochaine transition dans 60 s
+  LED_BUILTIN_BLINK_TIMING_START(60000, 60000, 1);
+  LED_BUILTIN_UPDATE();   // première transition (OFF -> ON) immédiate
+  report("Rien d'échu    ", measureUpdate(), overhead);
+  
+  LED_BUILTIN_STOP();
+  Serial.println("\nBenchmark terminé");
+}
+
+void loop() {
+  LED_BUILTIN_UPDATE();
+}
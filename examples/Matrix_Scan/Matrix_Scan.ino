@@ -0,0 +1,79 @@
+/*
+  LED_BUILTIN.h - Matrice de LED balayée par interruption timer
+  
+  ============================================================================
+  Matrice 4 × 4 (anodes sur les lignes, cathodes sur les colonnes via
+  résistances). Le balayage est assuré par une interruption timer à 200 Hz
+  par trame : l'affichage ne scintille pas même si loop() est bloquée.
+  Les animations (blink / pattern) écrivent dans le framebuffer de la
+  matrice comme sur n'importe quel canal.
+  
+  Les statistiques de balayage (fréquence réelle, durée de l'ISR, charge
+  CPU) sont affichées chaque seconde.
+  
+  Broches : premier banc GPIO uniquement (0-31 sur ESP32, 0-15 sur ESP8266).
+  ============================================================================
+*/
+
+// Options du moteur (build_flags de platformio.ini ou LED_BUILTIN_config.h) :
+//   -D LED_CHANNEL_COUNT=17          ; LED_BUILTIN + 16 LED de la matrice
+//   -D LED_BUILTIN_BACKEND_MATRIX
+//   -D LED_MATRIX_ROWS=4
+//   -D LED_MATRIX_COLS=4
+
+#include <Arduino.h>
+#include "LED_BUILTIN.h"
+
+#if LED_CHANNEL_COUNT != 17 || !defined(LED_BUILTIN_BACKEND_MATRIX) || LED_MATRIX_ROWS != 4 || LED_MATRIX_COLS != 4
+  #error "Build with -D LED_CHANNEL_COUNT=17 -D LED_BUILTIN_BACKEND_MATRIX -D LED_MATRIX_ROWS=4 -D LED_MATRIX_COLS=4"
+#endif
+
+#if defined(ESP8266)
+  static const uint8_t rowPins[LED_MATRIX_ROWS] = {5, 4, 0, 2};      // D1 D2 D3 D4
+  static const uint8_t colPins[LED_MATRIX_COLS] = {14, 12, 13, 15};  // D5 D6 D7 D8
+#else
+  static const uint8_t rowPins[LED_MATRIX_ROWS] = {16, 17, 18, 19};
+  static const uint8_t colPins[LED_MATRIX_COLS] = {21, 22, 23, 25};
+#endif
+
+static const uint8_t chase_pattern[] = {1, 0};
+static const uint16_t chase_times[] = {150, 2250};
+
+void setup() {
+  Serial.begin(115200);
+  delay(100);
+  
+  ENABLE_LED_BUILTIN();
+  if(!LED_MATRIX_BEGIN(rowPins, colPins, 200)) {
+    Serial.println("Erreur : broche hors du premier banc GPIO ou timer indisponible");
+  }
+}
+
+void loop() {
+  LED_BUILTIN_UPDATE();
+  
+  // Chenillard : chaque LED démarre avec un décalage de 150 ms
+  static uint16_t next_led = 1;
+  static unsigned long last_start = 0;
+  if(next_led < LED_CHANNEL_COUNT && millis() - last_start >= 150) {
+    LED_CHANNEL_PATTERN_START(next_led++, chase_pattern, chase_times, 2, 255);
+    last_start = millis();
+  }
+  
+  static unsigned long last_stats = 0;
+  if(millis() - last_stats >= 1000) {
+    last_stats = millis();
+    
+    LED_ScanStats_t stats;
+    LED_SCAN_GET_STATS(&stats);
+    Serial.print("Rafraîchissement : ");
+    Serial.print(stats.refresh_hz, 1);
+    Serial.print(" Hz, ISR moy. ");
+    Serial.print(stats.isr_avg_us, 2);
+    Serial.print(" µs, max ");
+    Serial.print(stats.isr_max_us, 2);
+    Serial.print(" µs, charge ");
+    Serial.print(stats.cpu_load, 2);
+    Serial.println(" %");
+  }
+}
@@ -0,0 +1,36 @@
+/*
+  LED_BUILTIN.h - Pilotage par protocole série binaire
+  
+  ============================================================================
+  Les motifs sont téléversés et démarrés depuis le PC, sans recompiler :
+  trames binaires courtes (CRC8), lues par LED_PROTO_POLL() dans un budget
+  de temps fixe à chaque tour de loop(), sans String ni allocation.
+  
+  Côté PC (pyserial) :
+    python3 extras/led_proto.py --port /dev/ttyUSB0 ping
+    python3 extras/led_proto.py --port /dev/ttyUSB0 upload 0 1:100,0:100,1:100,0:700
+    python3 extras/led_proto.py --port /dev/ttyUSB0 pattern 0 0 5
+    python3 extras/led_proto.py --port /dev/ttyUSB0 state 0
+    python3 extras/led_proto.py --port /dev/ttyUSB0 flood 0 500
+  
+  Le port série ne doit servir qu'au protocole (pas de Serial.print()).
+  ============================================================================
+*/
+
+#include <Arduino.h>
+#include "LED_BUILTIN.h"
+#include "LED_BUILTIN_Protocol.h"
+
+void setup() {
+  Serial.begin(115200);
+  
+  ENABLE_LED_BUILTIN();
+  LED_BUILTIN_BLINK_START(50, 3);   // signe de vie au démarrage
+}
+
+void loop() {
+  LED_BUILTIN_UPDATE();
+  LED_PROTO_POLL(Serial);           // au plus LED_PROTO_BUDGET_US (200 µs)
+  
+  // ... reste de l'application
+}
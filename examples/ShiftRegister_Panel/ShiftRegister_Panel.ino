@@ -0,0 +1,68 @@
+/*
+  LED_BUILTIN.h - Panneau de LED d'état sur registres à décalage 74HC595
+  
+  ============================================================================
+  32 LED d'état (4 × 74HC595 chaînés) animées indépendamment.
+  Chaque passe de LED_BUILTIN_UPDATE() qui modifie au moins une LED émet une
+  seule trame SPI (DMA sur ESP32), quel que soit le nombre de LED changées.
+  
+  Câblage :
+    MCU MOSI  -> SER   (DS, broche 14) du premier 74HC595
+    MCU SCK   -> SRCLK (SHCP, broche 11) de tous les registres
+    LATCH_PIN -> RCLK  (STCP, broche 12) de tous les registres
+    Q7' (broche 9) de chaque registre -> SER du registre suivant
+    ESP8266 : MOSI = GPIO 13 (D7), SCK = GPIO 14 (D5)
+  
+  Canal 0 = LED_BUILTIN, canal 1 = Q0 du premier registre, ..., canal 32 =
+  Q7 du quatrième registre.
+  ============================================================================
+*/
+
+// Options du moteur (build_flags de platformio.ini ou LED_BUILTIN_config.h) :
+//   -D LED_CHANNEL_COUNT=33
+//   -D LED_BUILTIN_BACKEND_SHIFTREG
+
+#include <Arduino.h>
+#include "LED_BUILTIN.h"
+
+#if LED_CHANNEL_COUNT != 33 || !defined(LED_BUILTIN_BACKEND_SHIFTREG)
+  #error "Build with -D LED_CHANNEL_COUNT=33 -D LED_BUILTIN_BACKEND_SHIFTREG"
+#endif
+
+#if defined(ESP8266)
+  #define LATCH_PIN 15   // D8
+#else
+  #define LATCH_PIN 5
+#endif
+
+void setup() {
+  Serial.begin(115200);
+  delay(100);
+  
+  ENABLE_LED_BUILTIN();
+  if(!LED_SHIFTREG_BEGIN(LATCH_PIN)) {
+    Serial.println("Erreur d'initialisation SPI");
+  }
+  
+  // Chaque LED clignote à un rythme légèrement différent
+  for(uint16_t ch = 1; ch < LED_CHANNEL_COUNT; ch++) {
+    LED_CHANNEL_BLINK_START(ch, 100 + ch * 10, 400 + ch * 15, 255);
+  }
+  
+  // La LED intégrée continue de fonctionner comme d'habitude
+  LED_BUILTIN_SOS_START();
+}
+
+void loop() {
+  LED_BUILTIN_UPDATE();
+  
+  // Relance les animations terminées
+  for(uint16_t ch = 1; ch < LED_CHANNEL_COUNT; ch++) {
+    if(!LED_CHANNEL_IS_ACTIVE(ch)) {
+      LED_CHANNEL_BLINK_START(ch, 100 + ch * 10, 400 + ch * 15, 255);
+    }
+  }
+  if(!LED_BUILTIN_IS_ACTIVE()) {
+    LED_BUILTIN_SOS_START();
+  }
+}
@@ -0,0 +1,282 @@
+//  --------------------------------------------------------------------------
+//  Stress_Bench.h  –  Charge de test commune au sketch Stress_Benchmark et
+//  au banc hôte extras/host_bench
+//  --------------------------------------------------------------------------
+//  Chaque scénario démarre N animations (clignotements et motifs, moitié-
+//  moitié) aux durées tirées d'un générateur pseudo-aléatoire à graine fixe :
+//  la même graine donne exactement la même charge sur la carte et sur l'hôte.
+//  Une animation terminée est relancée à l'identique, N reste constant.
+//
+//  Le programme appelant fournit, avant l'#include :
+//    BENCH_TICKS()        compteur du temps CPU (cycles, ns...)
+//    BENCH_TICKS_PER_US   unités de BENCH_TICKS() par µs
+//    BENCH_NOW_US()       horloge des transitions (micros() ou temps simulé)
+//  et, en option, BENCH_PIN : broche sur laquelle les canaux 1 à N-1 sont
+//  attachés pour inclure digitalWrite() dans la mesure.
+//
+//  Mesures par scénario :
+//    • temps CPU par appel à LED_BUILTIN_UPDATE() : chaque passage par le
+//      chemin lent est chronométré ; le chemin rapide, trop court pour être
+//      chronométré appel par appel, est mesuré en boucle serrée par benchEnd()
+//    • retard de chaque transition sur son échéance (next_time du canal),
+//      hors temps passé dans le relevé du banc lui-même
+//    • octets de RAM du moteur par animation
+//  --------------------------------------------------------------------------
+
+#ifndef STRESS_BENCH_H
+#define STRESS_BENCH_H
+#include "LED_BUILTIN.h"
+
+#if defined(LED_BUILTIN_BACKEND_SHIFTREG) || defined(LED_BUILTIN_BACKEND_MATRIX) || \
+    defined(LED_BUILTIN_BACKEND_CHARLIEPLEX) || defined(LED_BUILTIN_BACKEND_BCM)
+  #error "Stress_Bench.h measures the default GPIO backend"
+#endif
+
+#ifndef BENCH_SEED
+  #define BENCH_SEED 1
+#endif
+#ifndef BENCH_MIN_MS
+  #define BENCH_MIN_MS 10     // durée minimale d'un pas
+#endif
+#ifndef BENCH_MAX_MS
+  #define BENCH_MAX_MS 500    // durée maximale d'un pas
+#endif
+#if BENCH_MIN_MS < 1 || BENCH_MAX_MS < BENCH_MIN_MS || BENCH_MAX_MS > 0x7FFF
+  #error "BENCH_MIN_MS / BENCH_MAX_MS must satisfy 1 <= MIN <= MAX <= 32767"
+#endif
+#define BENCH_PATTERNS      8
+#define BENCH_PATTERN_STEPS 16
+#define BENCH_FAST_CALLS    10000   // appels de la mesure du chemin rapide
+
+// Nombres d'animations simultanées ; ceux qui dépassent LED_CHANNEL_COUNT
+// sont ignorés
+static const uint16_t BENCH_SCENARIOS[] = {1, 8, 64, 256};
+#define BENCH_SCENARIO_COUNT (sizeof(BENCH_SCENARIOS) / sizeof(BENCH_SCENARIOS[0]))
+
+// Mémoire du moteur par canal : état + octet d'attribution GPIO
+#if LED_CHANNEL_COUNT > 1
+  #define BENCH_BYTES_PER_CHANNEL (sizeof(LED_Control_t) + 1)
+#else
+  #define BENCH_BYTES_PER_CHANNEL sizeof(LED_Control_t)
+#endif
+
+typedef struct {
+  uint16_t animations;
+  uint32_t loops;            // appels à LED_BUILTIN_UPDATE()
+  uint32_t slow_calls;       // appels passés par le chemin lent
+  uint32_t transitions;      // pas d'animation exécutés
+  uint64_t slow_ticks;       // temps CPU cumulé du chemin lent
+  uint32_t slow_ticks_max;
+  uint32_t fast_ticks;       // temps de BENCH_FAST_CALLS appels au chemin rapide
+  uint64_t late_us;          // retards cumulés
+  uint32_t late_us_max;
+} BenchStats_t;
+
+static BenchStats_t bench;
+static uint32_t bench_rng;
+static uint32_t bench_overhead;                      // coût d'une paire BENCH_TICKS()
+static uint16_t bench_on[LED_CHANNEL_COUNT];         // 0 = motif
+static uint16_t bench_off[LED_CHANNEL_COUNT];        // durée OFF, ou index du motif
+static uint32_t bench_key[LED_CHANNEL_COUNT];        // avancement vu au dernier passage
+static uint32_t bench_due_us[LED_CHANNEL_COUNT];     // échéance attendue (µs)
+static uint32_t bench_scan_end_us;                   // fin du dernier relevé (µs)
+
+#ifndef LED_BUILTIN_NO_PATTERNS
+  static uint8_t bench_levels[BENCH_PATTERNS][BENCH_PATTERN_STEPS];
+  static uint16_t bench_times[BENCH_PATTERNS][BENCH_PATTERN_STEPS];
+  static uint8_t bench_length[BENCH_PATTERNS];
+#endif
+
+// ============================================================================
+// GÉNÉRATION DE LA CHARGE
+// ============================================================================
+static uint32_t benchRandom() {
+  // xorshift32 : identique sur toutes les plates-formes
+  bench_rng ^= bench_rng << 13;
+  bench_rng ^= bench_rng >> 17;
+  bench_rng ^= bench_rng << 5;
+  return bench_rng;
+}
+
+static uint16_t benchDuration() {
+  return BENCH_MIN_MS + benchRandom() % (BENCH_MAX_MS - BENCH_MIN_MS + 1);
+}
+
+// Avancement d'un canal : change à chaque pas exécuté
+static uint32_t benchKey(const LED_Control_t* c) {
+  uint32_t key = ((uint32_t)c->state << 30) | ((uint32_t)c->current_count << 22) |
+                 ((uint32_t)c->led_is_on << 21);
+#ifndef LED_BUILTIN_NO_PATTERNS
+  key |= ((uint32_t)c->pattern_current_repeat << 8) | c->pattern_index;
+#endif
+  return key;
+}
+
+static void benchStart(uint16_t ch) {
+#ifndef LED_BUILTIN_NO_PATTERNS
+  if(bench_on[ch] == 0) {
+    uint16_t p = bench_off[ch];
+    LED_CHANNEL_PATTERN_START(ch, bench_levels[p], bench_times[p], bench_length[p], 255);
+  } else
+#endif
+  {
+    LED_CHANNEL_BLINK_START(ch, bench_on[ch], bench_off[ch], 255);
+  }
+  // Premier pas dû immédiatement : next_time vaut millis(), arrondi à la ms
+  bench_key[ch] = benchKey(LED_CHANNEL_GET_CONTROL(ch));
+  bench_due_us[ch] = BENCH_NOW_US();
+}
+
+/**
+ * @brief Arrête tous les canaux puis démarre le scénario à n animations
+ */
+static void benchBegin(uint16_t n) {
+  for(uint16_t ch = 0; ch < LED_CHANNEL_COUNT; ch++) {
+    if(LED_CHANNEL_IS_ACTIVE(ch)) LED_CHANNEL_STOP(ch);
+  }
+  LED_BUILTIN_UPDATE();
+
+  // Même graine pour chaque scénario : les n premiers canaux sont identiques
+  bench_rng = BENCH_SEED ? BENCH_SEED : 1;
+#ifndef LED_BUILTIN_NO_PATTERNS
+  for(uint8_t p = 0; p < BENCH_PATTERNS; p++) {
+    bench_length[p] = 2 + benchRandom() % (BENCH_PATTERN_STEPS - 1);
+    for(uint8_t i = 0; i < bench_length[p]; i++) {
+      bench_levels[p][i] = (i & 1) ? 0 : 1;
+      bench_times[p][i] = benchDuration();
+    }
+  }
+#endif
+  for(uint16_t ch = 0; ch < n; ch++) {
+#ifndef LED_BUILTIN_NO_PATTERNS
+    if(benchRandom() & 1) {
+      bench_on[ch] = 0;
+      bench_off[ch] = benchRandom() % BENCH_PATTERNS;
+      continue;
+    }
+#endif
+    bench_on[ch] = benchDuration();
+    bench_off[ch] = benchDuration();
+  }
+
+  // Coût de la mesure elle-même, retiré de chaque appel
+  bench_overhead = UINT32_MAX;
+  for(uint16_t i = 0; i < 256; i++) {
+    uint32_t start = BENCH_TICKS();
+    uint32_t ticks = BENCH_TICKS() - start;
+    if(ticks < bench_overhead) bench_overhead = ticks;
+  }
+
+#if defined(BENCH_PIN) && LED_CHANNEL_COUNT > 1
+  for(uint16_t ch = 1; ch < n; ch++) LED_CHANNEL_ATTACH(ch, BENCH_PIN);
+#endif
+
+  memset(&bench, 0, sizeof(bench));
+  bench.animations = n;
+  for(uint16_t ch = 0; ch < n; ch++) benchStart(ch);
+  bench_scan_end_us = BENCH_NOW_US();
+}
+
+// ============================================================================
+// MESURE
+// ============================================================================
+/**
+ * @brief Un tour de loop() : LED_BUILTIN_UPDATE() chronométré, puis relevé
+ *        des transitions exécutées (hors chronométrage)
+ */
+static void benchLoop() {
+  uint16_t n = bench.animations;
+  uint32_t now_us = BENCH_NOW_US();
+  uint32_t sched = led_sched_clock;
+  uint32_t delta = led_sched_delta;
+  bool due = led_active_count != 0 && (uint32_t)(LED_BUILTIN_FAST_CLOCK() - sched) >= delta;
+
+  uint32_t start = BENCH_TICKS();
+  bool active = LED_BUILTIN_UPDATE();
+  uint32_t ticks = BENCH_TICKS() - start;
+  ticks = ticks > bench_overhead ? ticks - bench_overhead : 0;
+
+  bench.loops++;
+  if(!due && active && led_sched_clock == sched && led_sched_delta == delta) return;   // chemin rapide
+
+  bench.slow_calls++;
+  bench.slow_ticks += ticks;
+  if(ticks > bench.slow_ticks_max) bench.slow_ticks_max = ticks;
+
+  for(uint16_t ch = 0; ch < n; ch++) {
+    const LED_Control_t* c = LED_CHANNEL_GET_CONTROL(ch);
+    if(benchKey(c) == bench_key[ch]) continue;
+
+    // Une échéance tombée pendant le relevé précédent n'est comptée qu'à
+    // partir de sa fin : le moteur n'avait pas la main
+    uint32_t from = bench_due_us[ch];
+    if((int32_t)(bench_scan_end_us - from) > 0) from = bench_scan_end_us;
+    int32_t late = (int32_t)(now_us - from);
+    if(late < 0) late = 0;
+    bench.transitions++;
+    bench.late_us += (uint32_t)late;
+    if((uint32_t)late > bench.late_us_max) bench.late_us_max = (uint32_t)late;
+
+    if(c->state == LED_STATE_IDLE) {
+      benchStart(ch);
+    } else {
+      // Échéance en µs, modulo 2^32 comme micros()
+      bench_key[ch] = benchKey(c);
+      bench_due_us[ch] = (uint32_t)c->next_time * 1000UL;
+    }
+  }
+  bench_scan_end_us = BENCH_NOW_US();
+}
+
+/**
+ * @brief Fin du scénario : mesure du chemin rapide, animations en cours
+ */
+static void benchEnd() {
+  LED_BUILTIN_UPDATE();   // traite ce qui serait échu
+  uint32_t start = BENCH_TICKS();
+  for(uint16_t i = 0; i < BENCH_FAST_CALLS; i++) {
+    LED_BUILTIN_UPDATE();
+    __asm__ __volatile__("" ::: "memory");
+  }
+  uint32_t ticks = BENCH_TICKS() - start;
+  bench.fast_ticks = ticks > bench_overhead ? ticks - bench_overhead : 0;
+}
+
+/**
+ * @brief Temps CPU moyen par appel à LED_BUILTIN_UPDATE(), en unités de BENCH_TICKS()
+ */
+static double benchTicksPerLoop() {
+  if(bench.loops == 0) return 0.0;
+  double fast = (double)bench.fast_ticks / BENCH_FAST_CALLS * (bench.loops - bench.slow_calls);
+  return (fast + (double)bench.slow_ticks) / bench.loops;
+}
+
+/**
+ * @brief Résultat du scénario sur une ligne JSON (voir extras/stress_compare.py)
+ * @param platform "host", "esp8266", "esp32"...
+ * @param cpu_mhz Fréquence CPU (0 si non significative)
+ * @param duration_ms Durée du scénario
+ */
+static int benchFormat(char* out, size_t size, const char* platform, uint16_t cpu_mhz, uint32_t duration_ms) {
+  double ns_per_tick = 1000.0 / BENCH_TICKS_PER_US;
+  return snprintf(out, size,
+    "{\"bench\":\"stress\",\"version\":\"%s\",\"platform\":\"%s\",\"cpu_mhz\":%u,"
+    "\"channels\":%u,\"animations\":%u,\"seed\":%lu,\"duration_ms\":%lu,"
+    "\"loops\":%lu,\"slow_calls\":%lu,\"transitions\":%lu,"
+    "\"update_ns_avg\":%.2f,\"fast_ns\":%.2f,\"slow_ns_avg\":%.1f,\"slow_ns_max\":%.1f,"
+    "\"late_us_avg\":%.1f,\"late_us_max\":%lu,"
+    "\"bytes_per_animation\":%u,\"engine_bytes\":%u}",
+    LED_BUILTIN_VERSION_STRING, platform, (unsigned)cpu_mhz,
+    (unsigned)LED_CHANNEL_COUNT, (unsigned)bench.animations, (unsigned long)BENCH_SEED,
+    (unsigned long)duration_ms,
+    (unsigned long)bench.loops, (unsigned long)bench.slow_calls, (unsigned long)bench.transitions,
+    benchTicksPerLoop() * ns_per_tick,
+    (double)bench.fast_ticks * ns_per_tick / BENCH_FAST_CALLS,
+    bench.slow_calls ? (double)bench.slow_ticks * ns_per_tick / bench.slow_calls : 0.0,
+    bench.slow_ticks_max * ns_per_tick,
+    bench.transitions ? (double)bench.late_us / bench.transitions : 0.0,
+    (unsigned long)bench.late_us_max,
+    (unsigned)BENCH_BYTES_PER_CHANNEL, (unsigned)(LED_CHANNEL_COUNT * BENCH_BYTES_PER_CHANNEL));
+}
+
+#endif // STRESS_BENCH_H
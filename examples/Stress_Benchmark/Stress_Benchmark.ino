@@ -0,0 +1,102 @@
+/*
+  LED_BUILTIN.h - Banc de charge : 1 à 256 animations simultanées
+
+  ============================================================================
+  Démarre successivement 1, 8, 64 puis 256 animations (clignotements et
+  motifs aux durées pseudo-aléatoires, graine fixe) et mesure pendant
+  BENCH_DURATION_MS chaque scénario :
+    - le temps CPU par appel à LED_BUILTIN_UPDATE() (moyen, chemin rapide,
+      chemin lent)
+    - le retard moyen et maximal d'une transition sur son échéance
+    - la RAM du moteur par animation
+  Chaque scénario produit une ligne JSON sur le port série. Ces lignes se
+  comparent d'une version à l'autre avec extras/stress_compare.py. Le banc
+  hôte extras/host_bench exécute la même charge (Stress_Bench.h) en temps
+  simulé.
+
+  Les canaux 1 à 255 ne sont attachés à aucune broche : seul le moteur est
+  mesuré. Définir BENCH_PIN pour les attacher tous à une broche libre et
+  inclure digitalWrite() dans la mesure.
+  ============================================================================
+*/
+
+// Options du moteur (build_flags de platformio.ini ou LED_BUILTIN_config.h) :
+//   -D LED_CHANNEL_COUNT=256
+// Les scénarios qui dépassent LED_CHANNEL_COUNT sont ignorés.
+
+#include <Arduino.h>
+#include "LED_BUILTIN.h"
+
+#define BENCH_TICKS()       ESP.getCycleCount()
+#define BENCH_TICKS_PER_US  ESP.getCpuFreqMHz()
+#define BENCH_NOW_US()      micros()
+#include "Stress_Bench.h"
+
+#ifndef BENCH_DURATION_MS
+  #define BENCH_DURATION_MS 10000
+#endif
+
+#if defined(PLATFORM_ESP8266)
+  #define BENCH_PLATFORM "esp8266"
+#else
+  #define BENCH_PLATFORM "esp32"
+#endif
+
+static uint8_t scenario = 0;
+static bool running = false;
+static uint32_t scenario_start;
+static char line[512];
+
+// ============================================================================
+// SCÉNARIOS
+// ============================================================================
+static bool nextScenario() {
+  while(scenario < BENCH_SCENARIO_COUNT && BENCH_SCENARIOS[scenario] > LED_CHANNEL_COUNT) {
+    scenario++;
+  }
+  if(scenario >= BENCH_SCENARIO_COUNT) return false;
+
+  Serial.print("# ");
+  Serial.print(BENCH_SCENARIOS[scenario]);
+  Serial.println(" animations...");
+  benchBegin(BENCH_SCENARIOS[scenario]);
+  scenario_start = millis();
+  return true;
+}
+
+// ============================================================================
+// SETUP
+// ============================================================================
+void setup() {
+  Serial.begin(115200);
+  delay(100);
+
+  Serial.println("\n\n# ========================================");
+  Serial.println("#   LED_BUILTIN - Banc de charge");
+  Serial.println("# ========================================");
+
+  ENABLE_LED_BUILTIN();
+  running = nextScenario();
+}
+
+// ============================================================================
+// LOOP - un tour = un appel mesuré à LED_BUILTIN_UPDATE()
+// ============================================================================
+void loop() {
+  if(!running) return;
+
+  benchLoop();
+  uint32_t elapsed = millis() - scenario_start;
+  if(elapsed < BENCH_DURATION_MS) return;
+
+  benchEnd();
+  benchFormat(line, sizeof(line), BENCH_PLATFORM, ESP.getCpuFreqMHz(), elapsed);
+  Serial.println(line);
+
+  scenario++;
+  running = nextScenario();
+  if(!running) {
+    for(uint16_t ch = 0; ch < LED_CHANNEL_COUNT; ch++) LED_CHANNEL_STOP(ch);
+    Serial.println("# Benchmark terminé");
+  }
+}
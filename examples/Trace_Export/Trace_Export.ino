@@ -0,0 +1,58 @@
+/*
+  LED_BUILTIN.h - Trace des transitions et export VCD
+  
+  ============================================================================
+  LED_BUILTIN_TRACE enregistre chaque transition de sortie (horodatage en µs,
+  canal, niveau, index de pattern) dans un tampon circulaire de taille fixe.
+  
+  Commandes sur le port série (115200 bauds) :
+    v : export VCD texte (copier/coller dans un fichier .vcd)
+    b : export binaire compact (à convertir avec extras/led_trace_vcd.py)
+    c : vide la trace
+  
+  Capture directe vers GTKWave :
+    python3 extras/led_trace_vcd.py --port /dev/ttyUSB0 --trigger b -o trace.vcd
+    gtkwave trace.vcd
+  ============================================================================
+*/
+
+// Options du moteur (build_flags de platformio.ini ou LED_BUILTIN_config.h) :
+//   -D LED_BUILTIN_TRACE
+//   -D LED_BUILTIN_TRACE_SIZE=128
+
+#include <Arduino.h>
+#include "LED_BUILTIN.h"
+
+#ifndef LED_BUILTIN_TRACE
+  #error "Build with -D LED_BUILTIN_TRACE"
+#endif
+
+void setup() {
+  Serial.begin(115200);
+  delay(100);
+  
+  ENABLE_LED_BUILTIN();
+  LED_BUILTIN_SOS_START();
+}
+
+void loop() {
+  // Répète le signal SOS en continu
+  if(!LED_BUILTIN_UPDATE()) {
+    LED_BUILTIN_SOS_START();
+  }
+  
+  if(Serial.available()) {
+    switch(Serial.read()) {
+      case 'v':
+        LED_BUILTIN_TRACE_DUMP_VCD(Serial);
+        break;
+      case 'b':
+        LED_BUILTIN_TRACE_DUMP_BINARY(Serial);
+        break;
+      case 'c':
+        LED_BUILTIN_TRACE_CLEAR();
+        Serial.println("Trace vidée");
+        break;
+    }
+  }
+}
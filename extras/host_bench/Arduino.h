@@ -0,0 +1,38 @@
+// Arduino.h minimal pour compiler le moteur LED_BUILTIN sur l'hôte
+// (banc extras/host_bench). Le temps est simulé : millis(), micros() et le
+// compteur de cycles ne dépendent que de host_sim_us, avancé par le banc.
+// Les E/S sont sans effet.
+
+#ifndef HOST_BENCH_ARDUINO_H
+#define HOST_BENCH_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#define HIGH   1
+#define LOW    0
+#define INPUT  0
+#define OUTPUT 1
+#define IRAM_ATTR
+
+#define HOST_CPU_MHZ 80   // fréquence simulée du compteur de cycles
+
+extern uint64_t host_sim_us;   // temps simulé ; unsigned long fait 64 bits sur l'hôte
+
+inline unsigned long micros() { return host_sim_us; }
+inline unsigned long millis() { return host_sim_us / 1000UL; }
+inline void delay(unsigned long) {}
+inline void yield() {}
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t, uint8_t) {}
+inline int digitalRead(uint8_t) { return LOW; }
+
+struct EspClass {
+  uint32_t getCycleCount() { return (uint32_t)(host_sim_us * HOST_CPU_MHZ); }
+  uint32_t getCpuFreqMHz() { return HOST_CPU_MHZ; }
+};
+extern EspClass ESP;
+
+#endif // HOST_BENCH_ARDUINO_H
@@ -0,0 +1,79 @@
+// Banc de charge hôte : la charge de examples/Stress_Benchmark exécutée en
+// temps simulé, une ligne JSON par scénario sur stdout (voir Makefile).
+//
+// Le temps des transitions est simulé : un tour de loop() dure entre la
+// moitié et 1,5 fois --loop-us µs, tiré d'un générateur à graine fixe comme
+// le reste de la charge. Transitions et retards sont donc reproductibles à
+// l'identique d'une exécution à l'autre. Seul le temps CPU de
+// LED_BUILTIN_UPDATE() est mesuré réellement (horloge monotone, en ns) :
+// chaque scénario est rejoué --repeat fois et la répétition la plus rapide
+// est retenue, ce qui écarte les préemptions de l'OS.
+//
+//   ./stress_bench_256 [--duration ms] [--loop-us µs] [--repeat n]
+
+#include <chrono>
+#include <stdlib.h>
+#include "Arduino.h"
+#include "LED_BUILTIN.h"
+
+uint64_t host_sim_us = 0;
+EspClass ESP;
+
+static inline uint32_t hostTicks() {
+  return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#define BENCH_TICKS()       hostTicks()
+#define BENCH_TICKS_PER_US  1000
+#define BENCH_NOW_US()      ((uint32_t)host_sim_us)
+#include "Stress_Bench.h"
+
+int main(int argc, char** argv) {
+  uint32_t duration_ms = 10000;
+  uint32_t loop_us = 50;
+  uint32_t repeat = 5;
+  for(int i = 1; i + 1 < argc; i += 2) {
+    if(strcmp(argv[i], "--duration") == 0) duration_ms = (uint32_t)strtoul(argv[i + 1], nullptr, 0);
+    else if(strcmp(argv[i], "--loop-us") == 0) loop_us = (uint32_t)strtoul(argv[i + 1], nullptr, 0);
+    else if(strcmp(argv[i], "--repeat") == 0) repeat = (uint32_t)strtoul(argv[i + 1], nullptr, 0);
+    else {
+      fprintf(stderr, "usage: %s [--duration ms] [--loop-us us] [--repeat n]\n", argv[0]);
+      return 2;
+    }
+  }
+  if(loop_us < 2) loop_us = 2;
+  if(repeat < 1) repeat = 1;
+
+  ENABLE_LED_BUILTIN();
+
+  char line[512];
+  for(size_t s = 0; s < BENCH_SCENARIO_COUNT; s++) {
+    if(BENCH_SCENARIOS[s] > LED_CHANNEL_COUNT) continue;
+    BenchStats_t fastest;
+    double ticks_per_loop = 0.0;
+    for(uint32_t r = 0; r < repeat; r++) {
+      // Départ sur une seconde entière : chaque répétition voit la même charge
+      host_sim_us = (host_sim_us / 1000000 + 1) * 1000000;
+      benchBegin(BENCH_SCENARIOS[s]);
+      uint32_t jitter = BENCH_SEED ^ 0x9E3779B9UL;   // distinct de la charge
+      uint64_t end_us = host_sim_us + (uint64_t)duration_ms * 1000;
+      while(host_sim_us < end_us) {
+        benchLoop();
+        jitter ^= jitter << 13;
+        jitter ^= jitter >> 17;
+        jitter ^= jitter << 5;
+        host_sim_us += loop_us / 2 + jitter % (loop_us + 1);
+      }
+      benchEnd();
+      if(r == 0 || benchTicksPerLoop() < ticks_per_loop) {
+        fastest = bench;
+        ticks_per_loop = benchTicksPerLoop();
+      }
+    }
+    bench = fastest;
+    benchFormat(line, sizeof(line), "host", 0, duration_ms);
+    puts(line);
+  }
+  return 0;
+}
@@ -0,0 +1,202 @@
+#!/usr/bin/env python3
+"""Pilote le moteur LED_BUILTIN par le protocole série binaire (LED_PROTO_POLL).
+
+pyserial est requis pour dialoguer avec la carte :
+
+    python3 led_proto.py --port /dev/ttyUSB0 ping
+    python3 led_proto.py --port /dev/ttyUSB0 blink 0 100 900 10
+    python3 led_proto.py --port /dev/ttyUSB0 upload 0 1:200,0:200,1:600,0:1000
+    python3 led_proto.py --port /dev/ttyUSB0 pattern 0 0 3
+    python3 led_proto.py --port /dev/ttyUSB0 state 0
+    python3 led_proto.py --port /dev/ttyUSB0 stop all
+    python3 led_proto.py --port /dev/ttyUSB0 flood 0 500     # 500 motifs aléatoires
+
+Sans --port, les trames sont écrites sur stdout (capture, rejeu).
+"""
+
+import argparse
+import random
+import struct
+import sys
+import time
+
+SYNC = 0xA5
+REPLY = 0x80
+
+CMD_PING, CMD_STOP, CMD_BLINK, CMD_UPLOAD, CMD_PATTERN, CMD_STATE, CMD_STATS = range(1, 8)
+ALL_CHANNELS = 0xFFFF
+
+STATUS = {0: "ok", 1: "longueur invalide", 2: "canal invalide", 3: "slot invalide",
+          4: "commande inconnue"}
+STATES = {0: "idle", 1: "blink", 2: "pattern"}
+
+
+def crc8(data):
+    crc = 0
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x07) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+def frame(seq, cmd, payload=b""):
+    body = bytes([len(payload), seq & 0xFF, cmd]) + payload
+    return bytes([SYNC]) + body + bytes([crc8(body)])
+
+
+def pack_steps(text):
+    """ "1:200,0:200" → pas compressés u16 : bit 15 = niveau, bits 0-14 = durée ms."""
+    out = b""
+    for step in text.split(","):
+        level, duration = step.split(":")
+        duration = int(duration)
+        if not 0 <= duration <= 0x7FFF:
+            raise ValueError("durée hors limites (0-32767 ms) : %d" % duration)
+        out += struct.pack("<H", (0x8000 if int(level) else 0) | duration)
+    return out
+
+
+class Reader:
+    """Parseur incrémental des réponses, symétrique de celui de la carte."""
+
+    def __init__(self):
+        self.buf = b""
+
+    def feed(self, data):
+        self.buf += data
+        replies = []
+        while True:
+            start = self.buf.find(bytes([SYNC]))
+            if start < 0:
+                self.buf = b""
+                return replies
+            self.buf = self.buf[start:]
+            if len(self.buf) < 2 or len(self.buf) < 5 + self.buf[1]:
+                return replies
+            length = self.buf[1]
+            body = self.buf[1:4 + length]
+            if crc8(body) != self.buf[4 + length]:
+                self.buf = self.buf[1:]
+                continue
+            replies.append((body[1], body[2] & ~REPLY, body[3:]))
+            self.buf = self.buf[5 + length:]
+
+
+def describe(cmd, data):
+    status = STATUS.get(data[0], "statut %d" % data[0])
+    if data[0] != 0:
+        return status
+    if cmd == CMD_PING:
+        version, channels, slots, steps = struct.unpack_from("<BHBB", data, 1)
+        if slots == 0:
+            return "version %d, %d canaux, sans motifs (LED_BUILTIN_NO_PATTERNS)" % (version, channels)
+        return "version %d, %d canaux, %d slots de %d pas" % (version, channels, slots, steps)
+    if cmd == CMD_STATE:
+        active, state, level, step, repeats, next_ms = struct.unpack_from("<HBBBBI", data, 1)
+        return "%s niveau=%d pas=%d répétitions=%d prochaine transition=%d ms (%d canaux actifs)" % (
+            STATES.get(state, state), level, step, repeats, next_ms, active)
+    if cmd == CMD_STATS:
+        names = ("trames", "erreurs_crc", "trames_rejetées", "réponses_retardées", "poll_max_us")
+        return " ".join("%s=%d" % kv for kv in zip(names, struct.unpack_from("<5I", data, 1)))
+    return status
+
+
+def channel(text):
+    return ALL_CHANNELS if text == "all" else int(text)
+
+
+def build(args, seq):
+    if args.command == "ping":
+        return frame(seq, CMD_PING)
+    if args.command == "stop":
+        return frame(seq, CMD_STOP, struct.pack("<H", channel(args.channel)))
+    if args.command == "blink":
+        return frame(seq, CMD_BLINK, struct.pack("<HHHB", args.channel, args.on_ms, args.off_ms, args.count))
+    if args.command == "upload":
+        return frame(seq, CMD_UPLOAD, bytes([args.slot]) + pack_steps(args.steps))
+    if args.command == "pattern":
+        return frame(seq, CMD_PATTERN, struct.pack("<HBB", args.channel, args.slot, args.repeat))
+    if args.command == "state":
+        return frame(seq, CMD_STATE, struct.pack("<H", args.channel))
+    if args.command == "stats":
+        return frame(seq, CMD_STATS)
+    raise ValueError(args.command)
+
+
+def flood(args):
+    """Téléverse puis démarre des motifs aléatoires : 2 trames par motif."""
+    rng = random.Random(args.seed)
+    for n in range(args.count):
+        steps = ",".join("%d:%d" % (i & 1 ^ 1, rng.randint(20, 300)) for i in range(rng.randint(2, 16)))
+        yield frame(2 * n, CMD_UPLOAD, bytes([n % args.slots]) + pack_steps(steps))
+        yield frame(2 * n + 1, CMD_PATTERN, struct.pack("<HBB", args.channel, n % args.slots, 1))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--port", help="port série (défaut : trames sur stdout)")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--timeout", type=float, default=1.0)
+    sub = parser.add_subparsers(dest="command", required=True)
+    sub.add_parser("ping")
+    sub.add_parser("stats")
+    p = sub.add_parser("stop")
+    p.add_argument("channel", help="canal ou 'all'")
+    p = sub.add_parser("blink")
+    p.add_argument("channel", type=int)
+    p.add_argument("on_ms", type=int)
+    p.add_argument("off_ms", type=int)
+    p.add_argument("count", type=int, nargs="?", default=1)
+    p = sub.add_parser("upload")
+    p.add_argument("slot", type=int)
+    p.add_argument("steps", help="niveau:durée_ms séparés par des virgules")
+    p = sub.add_parser("pattern")
+    p.add_argument("channel", type=int)
+    p.add_argument("slot", type=int)
+    p.add_argument("repeat", type=int, nargs="?", default=1)
+    p = sub.add_parser("state")
+    p.add_argument("channel", type=int)
+    p = sub.add_parser("flood")
+    p.add_argument("channel", type=int)
+    p.add_argument("count", type=int)
+    p.add_argument("--slots", type=int, default=4)
+    p.add_argument("--seed", type=int, default=1)
+    args = parser.parse_args()
+
+    frames = list(flood(args)) if args.command == "flood" else [build(args, 0)]
+
+    if not args.port:
+        for f in frames:
+            sys.stdout.buffer.write(f)
+        return
+
+    import serial  # pyserial
+
+    reader = Reader()
+    with serial.Serial(args.port, args.baud, timeout=0.05) as link:
+        start = time.time()
+        pending = 0
+        for f in frames:
+            link.write(f)
+            pending += 1
+            for seq, cmd, data in reader.feed(link.read(link.in_waiting)):
+                pending -= 1
+                if data[0] != 0 or args.command != "flood":
+                    print("[%d] %s" % (seq, describe(cmd, data)))
+        deadline = time.time() + args.timeout
+        while pending > 0 and time.time() < deadline:
+            for seq, cmd, data in reader.feed(link.read(64)):
+                pending -= 1
+                if data[0] != 0 or args.command != "flood":
+                    print("[%d] %s" % (seq, describe(cmd, data)))
+        if args.command == "flood":
+            elapsed = time.time() - start
+            print("%d trames en %.2f s (%.0f motifs/s), %d sans réponse" % (
+                len(frames), elapsed, args.count / elapsed, pending))
+        elif pending:
+            sys.exit("pas de réponse de la carte")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,119 @@
+#!/usr/bin/env python3
+"""Convertit une trace binaire LED_BUILTIN ("LEDT") en fichier VCD pour GTKWave.
+
+La trace est produite sur la carte par LED_BUILTIN_TRACE_DUMP_BINARY().
+Elle peut être lue depuis un fichier capturé ou directement sur le port
+série (pyserial requis) :
+
+    python3 led_trace_vcd.py capture.bin -o trace.vcd
+    python3 led_trace_vcd.py --port /dev/ttyUSB0 --trigger b -o trace.vcd
+"""
+
+import argparse
+import struct
+import sys
+import time
+
+MAGIC = b"LEDT"
+HEADER = struct.Struct("<4sBBHI")      # magic, version, taille entrée, nombre, perdues
+ENTRY = struct.Struct("<IBBBx")        # time_us, channel, level, index
+
+
+def parse(data):
+    """Retourne (entrées, perdues) depuis un flux contenant une trace LEDT."""
+    start = data.find(MAGIC)
+    if start < 0:
+        raise ValueError("en-tête LEDT introuvable")
+    if len(data) < start + HEADER.size:
+        raise ValueError("en-tête LEDT tronqué")
+    magic, version, entry_size, count, dropped = HEADER.unpack_from(data, start)
+    if version != 1:
+        raise ValueError("version de trace non supportée : %d" % version)
+    if entry_size < ENTRY.size:
+        raise ValueError("taille d'entrée invalide : %d" % entry_size)
+    offset = start + HEADER.size
+    if len(data) < offset + count * entry_size:
+        raise ValueError("trace tronquée : %d entrées attendues" % count)
+    entries = [ENTRY.unpack_from(data, offset + n * entry_size) for n in range(count)]
+    return entries, dropped
+
+
+def vcd_id(signal):
+    out = ""
+    while True:
+        out += chr(ord("!") + signal % 94)
+        signal //= 94
+        if signal == 0:
+            return out
+
+
+def write_vcd(entries, out):
+    channels = sorted({e[1] for e in entries}) or [0]
+    out.write("$timescale 1us $end\n$scope module led_builtin $end\n")
+    for ch in channels:
+        out.write("$var wire 1 %s led%d $end\n" % (vcd_id(ch * 2), ch))
+        out.write("$var wire 8 %s index%d $end\n" % (vcd_id(ch * 2 + 1), ch))
+    out.write("$upscope $end\n$enddefinitions $end\n")
+    if not entries:
+        return
+    origin = entries[0][0]
+    last = None
+    for time_us, channel, level, index in entries:
+        t = (time_us - origin) & 0xFFFFFFFF
+        if t != last:
+            out.write("#%d\n" % t)
+            last = t
+        out.write("%d%s\n" % (level, vcd_id(channel * 2)))
+        out.write("b{:08b} {}\n".format(index, vcd_id(channel * 2 + 1)))
+
+
+def read_serial(port, baud, trigger, timeout):
+    import serial  # pyserial
+
+    with serial.Serial(port, baud, timeout=0.1) as link:
+        link.reset_input_buffer()
+        if trigger:
+            link.write(trigger.encode())
+        data = b""
+        deadline = time.time() + timeout
+        while time.time() < deadline:
+            data += link.read(4096)
+            try:
+                parse(data)
+                return data
+            except ValueError:
+                continue
+    raise TimeoutError("aucune trace complète reçue sur %s" % port)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("input", nargs="?", help="capture binaire (défaut : stdin)")
+    parser.add_argument("-o", "--output", help="fichier VCD (défaut : stdout)")
+    parser.add_argument("--port", help="port série à lire au lieu d'un fichier")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--trigger", help="caractère envoyé pour déclencher l'export")
+    parser.add_argument("--timeout", type=float, default=10.0)
+    args = parser.parse_args()
+
+    if args.port:
+        data = read_serial(args.port, args.baud, args.trigger, args.timeout)
+    elif args.input:
+        with open(args.input, "rb") as f:
+            data = f.read()
+    else:
+        data = sys.stdin.buffer.read()
+
+    entries, dropped = parse(data)
+    if dropped:
+        sys.stderr.write("attention : %d transitions perdues (tampon plein)\n" % dropped)
+
+    if args.output:
+        with open(args.output, "w") as f:
+            write_vcd(entries, f)
+    else:
+        write_vcd(entries, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,92 @@
+#!/usr/bin/env python3
+"""Mesure l'empreinte flash / RAM de chaque fonctionnalité de LED_BUILTIN.
+
+Compile les environnements size_<carte>_<variante> de platformio.ini
+(extras/size_report/main.cpp) puis affiche, par carte, la taille de chaque
+variante et son écart avec la variante "minimal" (moteur seul, sans API
+flottante, motifs ni RGB). La variante "minimal" est elle-même comparée à
+"empty" (framework seul) :
+
+    python3 extras/size_report.py
+    python3 extras/size_report.py --board esp12e --json
+"""
+
+import argparse
+import configparser
+import json
+import os
+import re
+import subprocess
+import sys
+
+PROJECT_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+USAGE = re.compile(r"^(RAM|Flash):.*\(used (\d+) bytes from (\d+) bytes\)", re.M)
+REFERENCE = {"empty": None, "minimal": "empty"}   # autres variantes : "minimal"
+
+
+def size_envs():
+    """Retourne {carte: [variantes]} d'après platformio.ini, dans l'ordre du fichier."""
+    config = configparser.ConfigParser(interpolation=None, inline_comment_prefixes=(";",))
+    config.read(os.path.join(PROJECT_DIR, "platformio.ini"))
+    boards = {}
+    for section in config.sections():
+        match = re.match(r"env:size_(.+?)_([a-z]+)$", section)
+        if match:
+            boards.setdefault(match.group(1), []).append(match.group(2))
+    return boards
+
+
+def build(pio, env):
+    """Compile un environnement et retourne {"flash": octets, "ram": octets}."""
+    result = subprocess.run([pio, "run", "-e", env], cwd=PROJECT_DIR,
+                            stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                            universal_newlines=True)
+    if result.returncode != 0:
+        sys.stderr.write(result.stdout)
+        raise RuntimeError("échec de compilation : %s" % env)
+    usage = {kind.lower(): int(used) for kind, used, _ in USAGE.findall(result.stdout)}
+    if set(usage) != {"flash", "ram"}:
+        raise RuntimeError("tailles introuvables dans la sortie de %s" % env)
+    return usage
+
+
+def report(board, sizes, out):
+    out.write("\n%s\n" % board)
+    out.write("  %-10s %10s %10s %12s %10s\n" % ("variante", "flash", "RAM", "Δ flash", "Δ RAM"))
+    for variant, size in sizes.items():
+        ref = REFERENCE.get(variant, "minimal")
+        if ref in sizes:
+            delta = "%+12d %+10d  (vs %s)" % (size["flash"] - sizes[ref]["flash"],
+                                              size["ram"] - sizes[ref]["ram"], ref)
+        else:
+            delta = ""
+        line = "  %-10s %10d %10d %s" % (variant, size["flash"], size["ram"], delta)
+        out.write(line.rstrip() + "\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--board", action="append", help="carte à mesurer (défaut : toutes)")
+    parser.add_argument("--pio", default="pio", help="commande PlatformIO (défaut : pio)")
+    parser.add_argument("--json", action="store_true", help="sortie JSON au lieu du tableau")
+    args = parser.parse_args()
+
+    results = {}
+    for board, variants in size_envs().items():
+        if args.board and board not in args.board:
+            continue
+        results[board] = {}
+        for variant in variants:
+            sys.stderr.write("compilation de size_%s_%s...\n" % (board, variant))
+            results[board][variant] = build(args.pio, "size_%s_%s" % (board, variant))
+
+    if args.json:
+        json.dump(results, sys.stdout, indent=2)
+        sys.stdout.write("\n")
+    else:
+        for board, sizes in results.items():
+            report(board, sizes, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
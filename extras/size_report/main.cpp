@@ -0,0 +1,43 @@
+// Programme de mesure de l'empreinte flash / RAM (voir extras/size_report.py).
+// Chaque environnement size_* de platformio.ini compile ce fichier avec un
+// jeu d'options ; seules les fonctionnalités activées sont appelées.
+// SIZE_REPORT_EMPTY mesure le framework seul (aucun appel à la bibliothèque).
+
+#include <Arduino.h>
+#include "LED_BUILTIN.h"
+
+#if !defined(SIZE_REPORT_EMPTY) && !defined(LED_BUILTIN_NO_PATTERNS)
+static const uint8_t size_pattern[] = {1, 0, 1, 0};
+static const uint16_t size_times[] = {100, 100, 300, 500};
+#endif
+
+void setup() {
+#ifndef SIZE_REPORT_EMPTY
+  ENABLE_LED_BUILTIN();
+  LED_BUILTIN_BLINK_START(100, 3);
+  LED_BUILTIN_BLINK_TIMING_START(50, 150, 2);
+  #ifndef LED_BUILTIN_NO_FLOAT_API
+    LED_BUILTIN_BLINK_DUTY_START(1000, 0.2f, 2);
+    LED_BUILTIN_BLINK_FREQ_START(2.5f, 0.5f, 2000);
+  #endif
+  #ifndef LED_BUILTIN_NO_PATTERNS
+    LED_BUILTIN_BLINK_PATTERN_START(size_pattern, size_times, 4, 2);
+    LED_BUILTIN_SOS_START();
+  #endif
+  #ifdef LED_BUILTIN_COMPATIBILITY_MODE
+    LED_BUILTIN_BLINK(100, 2);
+  #endif
+  #ifdef LED_BUILTIN_TRACE
+    LED_BUILTIN_TRACE_DUMP_BINARY(Serial);
+  #endif
+  #ifdef LED_RGB_AVAILABLE
+    LED_RGB_GREEN();
+  #endif
+#endif
+}
+
+void loop() {
+#ifndef SIZE_REPORT_EMPTY
+  LED_BUILTIN_UPDATE();
+#endif
+}
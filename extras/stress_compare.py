@@ -0,0 +1,85 @@
+#!/usr/bin/env python3
+"""Compare deux relevés du banc de charge LED_BUILTIN (JSON Lines).
+
+Les relevés viennent du banc hôte (extras/host_bench, `make run`) ou du
+sketch examples/Stress_Benchmark (lignes JSON du moniteur série). Les
+scénarios sont appariés par plate-forme, canaux compilés, animations et
+graine ; le script signale chaque mesure qui dépasse la référence de plus de
+--threshold % (et d'un écart minimal propre à la mesure, pour ignorer le
+bruit des très petites valeurs). Code de sortie 1 en cas de régression :
+
+    python3 extras/stress_compare.py v3.0.0.jsonl nouveau.jsonl
+    python3 extras/stress_compare.py --threshold 5 avant.jsonl apres.jsonl
+"""
+
+import argparse
+import json
+import sys
+
+# mesure -> écart absolu minimal pour être une régression
+METRICS = {
+    "update_ns_avg": 5.0,
+    "slow_ns_avg": 20.0,
+    "late_us_avg": 5.0,
+    "late_us_max": 5.0,
+    "bytes_per_animation": 0.0,
+    "engine_bytes": 0.0,
+}
+
+
+def load(path):
+    """Retourne {(plate-forme, canaux, animations, graine): mesures}."""
+    runs = {}
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            if not line.startswith("{"):
+                continue   # autres lignes du moniteur série
+            run = json.loads(line)
+            if run.get("bench") != "stress":
+                continue
+            runs[(run["platform"], run["channels"], run["animations"], run["seed"])] = run
+    return runs
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("baseline", help="relevé de référence")
+    parser.add_argument("current", help="relevé à vérifier")
+    parser.add_argument("--threshold", type=float, default=10.0,
+                        help="hausse tolérée en %% (défaut : 10)")
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    current = load(args.current)
+    common = sorted(set(baseline) & set(current))
+    if not common:
+        sys.exit("aucun scénario commun aux deux relevés")
+
+    regressions = 0
+    sys.stdout.write("%-8s %5s %5s  %-20s %12s %12s %8s\n" % (
+        "platform", "can.", "anim.", "mesure", "référence", "actuel", "écart"))
+    for key in common:
+        old, new = baseline[key], current[key]
+        if key[0] == "host" and (old["transitions"], old["slow_calls"]) != (new["transitions"], new["slow_calls"]):
+            # Temps simulé : ces compteurs ne changent qu'avec le comportement du moteur
+            sys.stdout.write("%-8s %5d %5d  comportement modifié : %d -> %d transitions, %d -> %d appels lents\n" % (
+                key[0], key[1], key[2], old["transitions"], new["transitions"],
+                old["slow_calls"], new["slow_calls"]))
+        for metric, floor in METRICS.items():
+            a, b = old[metric], new[metric]
+            delta = "%+7.1f%%" % ((b - a) * 100.0 / a) if a else "      —"
+            regressed = b - a > floor and b > a * (1 + args.threshold / 100.0)
+            regressions += regressed
+            sys.stdout.write("%-8s %5d %5d  %-20s %12g %12g %8s%s\n" % (
+                key[0], key[1], key[2], metric, a, b, delta, "  RÉGRESSION" if regressed else ""))
+
+    for name, runs in (("référence", baseline), ("actuel", current)):
+        for key in sorted(set(runs) - set(common)):
+            sys.stdout.write("scénario absent de l'autre relevé (%s) : %s\n" % (name, key))
+    sys.stdout.write("%d régression(s) sur %d scénario(s)\n" % (regressions, len(common)))
+    sys.exit(1 if regressions else 0)
+
+
+if __name__ == "__main__":
+    main()
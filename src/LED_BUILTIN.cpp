@@ -0,0 +1,1191 @@
+//  --------------------------------------------------------------------------
+//  LED_BUILTIN.cpp  –  Moteur non-bloquant (instance unique)
+//  --------------------------------------------------------------------------
+//  Toutes les options sont lues dans LED_BUILTIN.h ; les fonctionnalités
+//  désactivées (LED_BUILTIN_NO_xxx, backends non choisis, trace) ne sont
+//  pas compilées.
+//  --------------------------------------------------------------------------
+
+// Compilation de la bibliothèque : les choix de LED faits dans le sketch
+// (HELTEC_V3_LED_GPIOxx, ESP32_C6_LED_GPIOxx) ne sont pas exigés ici
+#define LED_BUILTIN_LIBRARY_BUILD
+#include "LED_BUILTIN.h"
+
+#ifdef LED_RGB_AVAILABLE
+  #include <Adafruit_NeoPixel.h>
+#endif
+
+// GPIO et état actif de LED_BUILTIN, fixés par ENABLE_LED_BUILTIN()
+static uint8_t led_builtin_pin = LED_BUILTIN;
+static uint8_t led_builtin_on_state = LED_ON_STATE;
+
+// ============================================
+// GESTION LED RGB
+// ============================================
+#ifdef LED_RGB_AVAILABLE
+
+  static Adafruit_NeoPixel* led_rgb_strip = nullptr;
+  static uint8_t led_rgb_r = 255, led_rgb_g = 255, led_rgb_b = 255;
+  static uint8_t led_rgb_brightness = 50; // 0-255
+
+  void LED_RGB_INIT(void) {
+    if(led_rgb_strip == nullptr) {
+      led_rgb_strip = new Adafruit_NeoPixel(1, led_builtin_pin, NEO_GRB + NEO_KHZ800);
+      led_rgb_strip->begin();
+      led_rgb_strip->setBrightness(led_rgb_brightness);
+      led_rgb_strip->show();
+    }
+  }
+
+  void LED_RGB_SET_COLOR(uint8_t r, uint8_t g, uint8_t b, uint8_t brightness) {
+    LED_RGB_INIT();
+    led_rgb_r = r;
+    led_rgb_g = g;
+    led_rgb_b = b;
+    if(brightness < 255) {
+      led_rgb_brightness = brightness;
+      led_rgb_strip->setBrightness(brightness);
+    }
+  }
+
+  void LED_RGB_ON(void) {
+    LED_RGB_INIT();
+    led_rgb_strip->setPixelColor(0, led_rgb_strip->Color(led_rgb_r, led_rgb_g, led_rgb_b));
+    led_rgb_strip->show();
+  }
+
+  void LED_RGB_OFF(void) {
+    LED_RGB_INIT();
+    led_rgb_strip->setPixelColor(0, 0);
+    led_rgb_strip->show();
+  }
+#endif
+
+// ============================================
+// ÉTAT DU MOTEUR
+// ============================================
+static LED_Control_t led_channels[LED_CHANNEL_COUNT];   // tous LED_STATE_IDLE au démarrage
+uint16_t led_active_count = 0;                          // canaux hors LED_STATE_IDLE
+static unsigned long led_deadline = 0;                  // next_time le plus proche (canaux actifs)
+
+// ============================================
+// HORLOGE RAPIDE DU CHEMIN CRITIQUE
+// ============================================
+
+// Horizon maximal d'une échéance en cycles (le compteur 32 bits reboucle
+// toutes les ~17 s à 240 MHz) : au-delà, le chemin lent est simplement
+// rappelé une fois par horizon pour recalculer l'échéance.
+#ifndef LED_BUILTIN_WAKE_HORIZON_US
+  #define LED_BUILTIN_WAKE_HORIZON_US 1000000UL
+#endif
+
+// Échéance = instant de planification + délai borné. Le chemin rapide compare
+// le temps écoulé (non signé) au délai : une échéance dépassée reste échue
+// jusqu'au rebouclage complet du compteur (2^32 cycles, ~17,9 s à 240 MHz)
+// et n'est au pire retardée que d'un horizon au-delà.
+uint32_t led_sched_clock = 0;
+uint32_t led_sched_delta = 0;
+
+// Instant du passage en cours dans le chemin lent, lu une seule fois par
+// passage : sert à la replanification et horodate les transitions tracées
+static uint32_t led_pass_clock = 0;
+static uint32_t led_pass_us = 0;
+
+/**
+ * @brief Calcule l'échéance rapide correspondant à led_deadline
+ */
+static void led_schedule(void) {
+  // led_deadline * 1000 et micros() rebouclent tous deux modulo 2^32
+  int32_t remaining_us = (int32_t)((uint32_t)led_deadline * 1000UL - led_pass_us);
+  if(remaining_us < 0) remaining_us = 0;
+  if((uint32_t)remaining_us > LED_BUILTIN_WAKE_HORIZON_US) remaining_us = LED_BUILTIN_WAKE_HORIZON_US;
+  led_sched_clock = led_pass_clock;
+  led_sched_delta = (uint32_t)remaining_us * LED_BUILTIN_FAST_CLOCK_PER_US();
+}
+
+/**
+ * @brief Force le passage par le chemin lent au prochain LED_BUILTIN_UPDATE()
+ */
+static inline void led_schedule_now(void) {
+  led_sched_delta = 0;
+}
+
+// ============================================
+// TRACE DES TRANSITIONS (optionnelle)
+// ============================================
+#ifdef LED_BUILTIN_TRACE
+
+  static LED_Trace_t led_trace_buf[LED_BUILTIN_TRACE_SIZE];
+  static uint32_t led_trace_head = 0;   // nombre total de transitions enregistrées
+
+  static inline void led_trace_record(uint32_t time_us, uint8_t channel, uint8_t level, uint8_t index) {
+    LED_Trace_t* e = &led_trace_buf[led_trace_head++ & (LED_BUILTIN_TRACE_SIZE - 1)];
+    e->time_us = time_us;
+    e->channel = channel;
+    e->level = level;
+    e->index = index;
+  }
+
+  // Transition du chemin lent : horodatage du passage, déjà lu
+  #define LED_TRACE_RECORD(channel, level, index) led_trace_record(led_pass_us, (channel), (level), (index))
+  // Transition hors du chemin lent (STOP, ...)
+  #define LED_TRACE_RECORD_NOW(channel, level, index) led_trace_record(micros(), (channel), (level), (index))
+
+  void LED_BUILTIN_TRACE_CLEAR(void) {
+    led_trace_head = 0;
+  }
+
+  uint16_t LED_BUILTIN_TRACE_COUNT(void) {
+    return led_trace_head < LED_BUILTIN_TRACE_SIZE ? (uint16_t)led_trace_head : LED_BUILTIN_TRACE_SIZE;
+  }
+
+  uint32_t LED_BUILTIN_TRACE_DROPPED(void) {
+    return led_trace_head > LED_BUILTIN_TRACE_SIZE ? led_trace_head - LED_BUILTIN_TRACE_SIZE : 0;
+  }
+
+  // Entrée n (0 = la plus ancienne encore présente)
+  static inline const LED_Trace_t* led_trace_entry(uint16_t n) {
+    uint32_t first = led_trace_head - LED_BUILTIN_TRACE_COUNT();
+    return &led_trace_buf[(first + n) & (LED_BUILTIN_TRACE_SIZE - 1)];
+  }
+
+  // Identifiant VCD d'un signal : base 94 sur les caractères imprimables
+  static void led_trace_vcd_id(Print& out, uint16_t signal) {
+    do {
+      out.write((uint8_t)('!' + signal % 94));
+      signal /= 94;
+    } while(signal != 0);
+  }
+
+  void LED_BUILTIN_TRACE_DUMP_VCD(Print& out) {
+    uint16_t count = LED_BUILTIN_TRACE_COUNT();
+    uint8_t max_channel = 0;
+    for(uint16_t n = 0; n < count; n++) {
+      if(led_trace_entry(n)->channel > max_channel) max_channel = led_trace_entry(n)->channel;
+    }
+    
+    out.println("$timescale 1us $end");
+    out.println("$scope module led_builtin $end");
+    for(uint16_t ch = 0; ch <= max_channel; ch++) {
+      out.print("$var wire 1 ");
+      led_trace_vcd_id(out, ch * 2);
+      out.print(" led");
+      out.print((unsigned long)ch);
+      out.println(" $end");
+      out.print("$var wire 8 ");
+      led_trace_vcd_id(out, ch * 2 + 1);
+      out.print(" index");
+      out.print((unsigned long)ch);
+      out.println(" $end");
+    }
+    out.println("$upscope $end");
+    out.println("$enddefinitions $end");
+    if(count == 0) return;
+    
+    uint32_t origin = led_trace_entry(0)->time_us;
+    uint32_t last = 0xFFFFFFFFUL;
+    for(uint16_t n = 0; n < count; n++) {
+      const LED_Trace_t* e = led_trace_entry(n);
+      uint32_t t = e->time_us - origin;
+      if(t != last) {
+        out.print("#");
+        out.println((unsigned long)t);
+        last = t;
+      }
+      out.write((uint8_t)(e->level ? '1' : '0'));
+      led_trace_vcd_id(out, e->channel * 2);
+      out.println();
+      out.write((uint8_t)'b');
+      for(int8_t bit = 7; bit >= 0; bit--) {
+        out.write((uint8_t)((e->index >> bit) & 1 ? '1' : '0'));
+      }
+      out.write((uint8_t)' ');
+      led_trace_vcd_id(out, e->channel * 2 + 1);
+      out.println();
+    }
+  }
+
+  void LED_BUILTIN_TRACE_DUMP_BINARY(Print& out) {
+    uint16_t count = LED_BUILTIN_TRACE_COUNT();
+    uint32_t dropped = LED_BUILTIN_TRACE_DROPPED();
+    const uint8_t header[] = {
+      'L', 'E', 'D', 'T', 1, (uint8_t)sizeof(LED_Trace_t),
+      (uint8_t)(count & 0xFF), (uint8_t)(count >> 8),
+      (uint8_t)(dropped & 0xFF), (uint8_t)(dropped >> 8),
+      (uint8_t)(dropped >> 16), (uint8_t)(dropped >> 24)
+    };
+    out.write(header, sizeof(header));
+    for(uint16_t n = 0; n < count; n++) {
+      out.write((const uint8_t*)led_trace_entry(n), sizeof(LED_Trace_t));
+    }
+  }
+
+#else
+  #define LED_TRACE_RECORD(channel, level, index) ((void)0)
+  #define LED_TRACE_RECORD_NOW(channel, level, index) ((void)0)
+#endif // LED_BUILTIN_TRACE
+
+// ============================================
+// BACKENDS DE SORTIE DES CANAUX 1..N
+// ============================================
+#if LED_CHANNEL_COUNT > 1
+
+#if defined(LED_BUILTIN_BACKEND_MATRIX) || defined(LED_BUILTIN_BACKEND_CHARLIEPLEX) || defined(LED_BUILTIN_BACKEND_BCM)
+  // ------------------------------------------------------------
+  // Timer matériel et accès GPIO directs, communs aux backends pilotés
+  // par interruption (balayage de matrice, modulation BCM).
+  // Le timer 1 est utilisé : timer1 sur ESP8266 (5 MHz), LED_TIMER_NUM
+  // sur ESP32 (10 MHz). Un seul de ces backends peut donc être actif.
+  // ------------------------------------------------------------
+  #if defined(PLATFORM_ESP8266)
+    #define LED_GPIO_FAST_MAX     16   // GPIO 0-15 (GPOS / GPOC)
+    #define LED_GPIO_OUT_SET(m)   (GPOS = (m))
+    #define LED_GPIO_OUT_CLR(m)   (GPOC = (m))
+    #define LED_GPIO_EN_SET(m)    (GPES = (m))
+    #define LED_GPIO_EN_CLR(m)    (GPEC = (m))
+    #define LED_ISR_LOCK()        uint32_t led_isr_ps = xt_rsil(15)
+    #define LED_ISR_UNLOCK()      xt_wsr_ps(led_isr_ps)
+    #define LED_ISR_LOCK_ISR()
+    #define LED_ISR_UNLOCK_ISR()
+    #define LED_TIMER_HZ          5000000UL   // TIM_DIV16 à 80 MHz d'APB
+  #elif defined(PLATFORM_ESP32)
+    #include <soc/gpio_reg.h>
+    #define LED_GPIO_FAST_MAX     32   // GPIO 0-31 (W1TS / W1TC du premier banc)
+    #define LED_GPIO_OUT_SET(m)   REG_WRITE(GPIO_OUT_W1TS_REG, (m))
+    #define LED_GPIO_OUT_CLR(m)   REG_WRITE(GPIO_OUT_W1TC_REG, (m))
+    #define LED_GPIO_EN_SET(m)    REG_WRITE(GPIO_ENABLE_W1TS_REG, (m))
+    #define LED_GPIO_EN_CLR(m)    REG_WRITE(GPIO_ENABLE_W1TC_REG, (m))
+    static portMUX_TYPE led_isr_mux = portMUX_INITIALIZER_UNLOCKED;
+    #define LED_ISR_LOCK()        portENTER_CRITICAL(&led_isr_mux)
+    #define LED_ISR_UNLOCK()      portEXIT_CRITICAL(&led_isr_mux)
+    #define LED_ISR_LOCK_ISR()    portENTER_CRITICAL_ISR(&led_isr_mux)
+    #define LED_ISR_UNLOCK_ISR()  portEXIT_CRITICAL_ISR(&led_isr_mux)
+    #define LED_TIMER_HZ          10000000UL
+    #ifndef LED_TIMER_NUM
+      #define LED_TIMER_NUM 1
+    #endif
+    static hw_timer_t* led_timer = nullptr;
+  #else
+    #error "Interrupt-driven LED backends require an ESP8266 or ESP32"
+  #endif
+
+  /**
+   * @brief Démarre le timer
+   * @param isr Routine d'interruption
+   * @param ticks Période initiale en ticks de LED_TIMER_HZ
+   * @param rearmed true si l'ISR fixe elle-même la période suivante (led_timer_rearm)
+   */
+  static bool led_timer_begin(void (*isr)(void), uint32_t ticks, bool rearmed) {
+  #if defined(PLATFORM_ESP8266)
+    timer1_attachInterrupt(isr);
+    timer1_enable(TIM_DIV16, TIM_EDGE, rearmed ? TIM_SINGLE : TIM_LOOP);
+    timer1_write(ticks);
+  #else
+    (void)rearmed;   // rechargement automatique : l'ISR ne modifie que l'alarme
+    #if defined(ESP_ARDUINO_VERSION_MAJOR) && ESP_ARDUINO_VERSION_MAJOR >= 3
+      led_timer = timerBegin(LED_TIMER_HZ);
+      if(led_timer == nullptr) return false;
+      timerAttachInterrupt(led_timer, isr);
+      timerAlarm(led_timer, ticks, true, 0);
+    #else
+      led_timer = timerBegin(LED_TIMER_NUM, 80000000UL / LED_TIMER_HZ, true);
+      if(led_timer == nullptr) return false;
+      timerAttachInterrupt(led_timer, isr, true);
+      timerAlarmWrite(led_timer, ticks, true);
+      timerAlarmEnable(led_timer);
+    #endif
+  #endif
+    return true;
+  }
+
+  // Depuis l'ISR : durée de la période suivante
+  static inline void IRAM_ATTR led_timer_rearm(uint32_t ticks) {
+  #if defined(PLATFORM_ESP8266)
+    timer1_write(ticks);
+  #elif defined(ESP_ARDUINO_VERSION_MAJOR) && ESP_ARDUINO_VERSION_MAJOR >= 3
+    timerAlarm(led_timer, ticks, true, 0);
+  #else
+    timerAlarmWrite(led_timer, ticks, true);
+  #endif
+  }
+
+  static void led_timer_end(void) {
+  #if defined(PLATFORM_ESP8266)
+    timer1_disable();
+    timer1_detachInterrupt();
+  #else
+    if(led_timer == nullptr) return;
+    #if !defined(ESP_ARDUINO_VERSION_MAJOR) || ESP_ARDUINO_VERSION_MAJOR < 3
+      timerAlarmDisable(led_timer);
+      timerDetachInterrupt(led_timer);
+    #endif
+    timerEnd(led_timer);
+    led_timer = nullptr;
+  #endif
+  }
+#endif
+
+#if defined(LED_BUILTIN_BACKEND_SHIFTREG)
+  // ------------------------------------------------------------
+  // Registres à décalage chaînés (74HC595) sur SPI
+  // ------------------------------------------------------------
+  #ifndef LED_SHIFTREG_POLARITY
+    #define LED_SHIFTREG_POLARITY 1   // 1 = sortie HIGH allume la LED, 0 = LED en puits
+  #endif
+  #define LED_SHIFTREG_BYTES ((LED_CHANNEL_COUNT - 1 + 7) / 8)
+
+  // Trame dans l'ordre d'émission : dernier registre de la chaîne en premier
+  static uint8_t led_frame[LED_SHIFTREG_BYTES];
+  static bool led_frame_dirty = false;
+  static uint32_t led_shiftreg_dropped = 0;   // passes où la trame n'a pas pu partir
+
+  #if defined(PLATFORM_ESP32)
+    #include <driver/spi_master.h>
+    #include <esp_attr.h>
+    #if __has_include(<esp_idf_version.h>)
+      #include <esp_idf_version.h>
+    #endif
+    #ifndef LED_SHIFTREG_SPI_HOST
+      #define LED_SHIFTREG_SPI_HOST SPI2_HOST
+    #endif
+    // SPI_DMA_CH_AUTO n'existe qu'à partir d'ESP-IDF 4.3 (arduino-esp32 2.0)
+    #if !defined(LED_SHIFTREG_DMA_CH) && defined(ESP_IDF_VERSION)
+      #if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(4, 3, 0)
+        #define LED_SHIFTREG_DMA_CH SPI_DMA_CH_AUTO
+      #endif
+    #endif
+    #ifndef LED_SHIFTREG_DMA_CH
+      #define LED_SHIFTREG_DMA_CH 1
+    #endif
+    // Attente maximale de la trame précédente avant d'abandonner la passe
+    #ifndef LED_SHIFTREG_WAIT_TICKS
+      #define LED_SHIFTREG_WAIT_TICKS 1   // ticks FreeRTOS
+    #endif
+    static DMA_ATTR uint8_t led_frame_tx[(LED_SHIFTREG_BYTES + 3) & ~3];
+    static spi_device_handle_t led_shiftreg_dev = nullptr;
+    static spi_transaction_t led_shiftreg_trans;
+    static bool led_shiftreg_busy = false;
+  #else
+    #include <SPI.h>
+    static uint8_t led_shiftreg_latch = 0;
+    static bool led_shiftreg_ready = false;
+    static SPISettings led_shiftreg_spi;
+  #endif
+
+  static inline void led_backend_write(uint16_t ch, bool on) {
+    uint16_t bit = ch - 1;
+    uint8_t* byte = &led_frame[LED_SHIFTREG_BYTES - 1 - bit / 8];
+    uint8_t mask = (uint8_t)(1 << (bit & 7));
+    uint8_t value = (on == (LED_SHIFTREG_POLARITY != 0)) ? (uint8_t)(*byte | mask) : (uint8_t)(*byte & ~mask);
+    if(value != *byte) {
+      *byte = value;
+      led_frame_dirty = true;
+    }
+  }
+
+  /**
+   * @brief Émet la trame si elle a changé depuis la dernière émission
+   */
+  static void led_backend_flush(void) {
+    if(!led_frame_dirty) return;
+  #if defined(PLATFORM_ESP32)
+    if(led_shiftreg_dev == nullptr) return;
+    if(led_shiftreg_busy) {
+      // La trame précédente est encore en cours de transfert DMA ; un bus
+      // bloqué ne doit pas figer LED_BUILTIN_UPDATE() : la trame reste en
+      // attente (dirty) et repartira à la passe suivante
+      spi_transaction_t* done;
+      if(spi_device_get_trans_result(led_shiftreg_dev, &done, LED_SHIFTREG_WAIT_TICKS) != ESP_OK) {
+        led_shiftreg_dropped++;
+        return;
+      }
+      led_shiftreg_busy = false;
+    }
+    memcpy(led_frame_tx, led_frame, LED_SHIFTREG_BYTES);
+    memset(&led_shiftreg_trans, 0, sizeof(led_shiftreg_trans));
+    led_shiftreg_trans.length = LED_SHIFTREG_BYTES * 8;
+    led_shiftreg_trans.tx_buffer = led_frame_tx;
+    if(spi_device_queue_trans(led_shiftreg_dev, &led_shiftreg_trans, 0) != ESP_OK) {
+      led_shiftreg_dropped++;
+      return;
+    }
+    led_shiftreg_busy = true;
+  #else
+    if(!led_shiftreg_ready) return;
+    SPI.beginTransaction(led_shiftreg_spi);
+    digitalWrite(led_shiftreg_latch, LOW);
+    SPI.writeBytes(led_frame, LED_SHIFTREG_BYTES);
+    digitalWrite(led_shiftreg_latch, HIGH);
+    SPI.endTransaction();
+  #endif
+    led_frame_dirty = false;
+  }
+
+  bool LED_SHIFTREG_BEGIN(uint8_t latch_pin, uint32_t spi_hz, int8_t data_pin, int8_t clock_pin) {
+  #if defined(PLATFORM_ESP32)
+    if(led_shiftreg_dev == nullptr) {
+      spi_bus_config_t bus;
+      memset(&bus, 0, sizeof(bus));
+      bus.mosi_io_num = data_pin >= 0 ? data_pin : MOSI;
+      bus.miso_io_num = -1;
+      bus.sclk_io_num = clock_pin >= 0 ? clock_pin : SCK;
+      bus.quadwp_io_num = -1;
+      bus.quadhd_io_num = -1;
+      bus.max_transfer_sz = sizeof(led_frame_tx);
+      if(spi_bus_initialize(LED_SHIFTREG_SPI_HOST, &bus, LED_SHIFTREG_DMA_CH) != ESP_OK) return false;
+      
+      spi_device_interface_config_t dev;
+      memset(&dev, 0, sizeof(dev));
+      dev.mode = 0;
+      dev.clock_speed_hz = (int)spi_hz;
+      dev.spics_io_num = latch_pin;
+      dev.queue_size = 1;
+      if(spi_bus_add_device(LED_SHIFTREG_SPI_HOST, &dev, &led_shiftreg_dev) != ESP_OK) {
+        spi_bus_free(LED_SHIFTREG_SPI_HOST);
+        return false;
+      }
+    }
+  #else
+    (void)data_pin;
+    (void)clock_pin;
+    led_shiftreg_latch = latch_pin;
+    led_shiftreg_spi = SPISettings(spi_hz, MSBFIRST, SPI_MODE0);
+    pinMode(latch_pin, OUTPUT);
+    digitalWrite(latch_pin, HIGH);
+    SPI.begin();
+    led_shiftreg_ready = true;
+  #endif
+    memset(led_frame, LED_SHIFTREG_POLARITY ? 0x00 : 0xFF, sizeof(led_frame));
+    led_frame_dirty = true;
+    led_backend_flush();
+    return true;
+  }
+
+  uint32_t LED_SHIFTREG_DROPPED(void) {
+    return led_shiftreg_dropped;
+  }
+
+#elif defined(LED_BUILTIN_BACKEND_MATRIX) || defined(LED_BUILTIN_BACKEND_CHARLIEPLEX)
+  // ------------------------------------------------------------
+  // Matrice multiplexée / charlieplexing balayée par timer
+  // ------------------------------------------------------------
+  #if defined(LED_BUILTIN_BACKEND_MATRIX)
+    #ifndef LED_MATRIX_ROW_ACTIVE_HIGH
+      #define LED_MATRIX_ROW_ACTIVE_HIGH 1   // ligne active = HIGH (anodes communes)
+    #endif
+    #ifndef LED_MATRIX_COL_ACTIVE_HIGH
+      #define LED_MATRIX_COL_ACTIVE_HIGH 0   // colonne allumée = LOW (cathodes)
+    #endif
+  #endif
+  #ifndef LED_SCAN_MIN_TICKS
+    #define LED_SCAN_MIN_TICKS (LED_TIMER_HZ / 100000UL)   // ligne la plus courte : 10 µs
+  #endif
+
+  // Masques d'une ligne, complets : chaque broche de la matrice figure dans
+  // out_clr ou dans out_set, aucune extinction préalable n'est nécessaire
+  typedef struct {
+    uint32_t out_clr;
+    uint32_t out_set;
+    uint32_t en_set;    // charlieplexing : broches sorties pour cette ligne
+  } LED_ScanRow_t;
+
+  static uint8_t led_scan_fb[(LED_SCAN_ROWS * LED_SCAN_COLS + 7) / 8];
+  static bool led_scan_dirty = false;
+  static uint8_t led_scan_row_pin[LED_SCAN_ROWS];
+  #if defined(LED_BUILTIN_BACKEND_MATRIX)
+    static uint8_t led_scan_col_pin[LED_SCAN_COLS];
+  #endif
+
+  static LED_ScanRow_t led_scan_back[LED_SCAN_ROWS];             // construit par loop()
+  static volatile LED_ScanRow_t led_scan_front[LED_SCAN_ROWS];   // lu par l'ISR
+  static uint32_t led_scan_blank_clr = 0;   // masques qui éteignent toutes les lignes
+  static uint32_t led_scan_blank_set = 0;
+  static uint32_t led_scan_blank_en = 0;
+  static volatile uint8_t led_scan_row = 0;
+  static bool led_scan_running = false;
+
+  // Statistiques (en cycles CPU)
+  static volatile uint32_t led_scan_frames = 0;
+  static volatile uint32_t led_scan_isr_count = 0;
+  static volatile uint32_t led_scan_isr_cycles = 0;
+  static volatile uint32_t led_scan_isr_max = 0;
+  static uint32_t led_scan_stats_since = 0;
+
+  static void IRAM_ATTR led_scan_isr(void) {
+    uint32_t start = LED_BUILTIN_FAST_CLOCK();
+    uint8_t row = led_scan_row;
+    
+    LED_ISR_LOCK_ISR();
+    uint32_t out_clr = led_scan_front[row].out_clr;
+    uint32_t out_set = led_scan_front[row].out_set;
+    uint32_t en_set = led_scan_front[row].en_set;
+    LED_ISR_UNLOCK_ISR();
+    
+  #if defined(LED_BUILTIN_BACKEND_MATRIX)
+    // Une écriture par registre. Le masque qui désactive l'ancienne ligne
+    // part en premier : entre les deux, aucune ligne n'est active.
+    (void)en_set;
+    if(LED_MATRIX_ROW_ACTIVE_HIGH) {
+      LED_GPIO_OUT_CLR(out_clr);
+      LED_GPIO_OUT_SET(out_set);
+    } else {
+      LED_GPIO_OUT_SET(out_set);
+      LED_GPIO_OUT_CLR(out_clr);
+    }
+  #else
+    // Charlieplexing : les niveaux ne changent qu'en haute impédance, d'où
+    // deux écritures de direction autour des deux écritures de niveau
+    LED_GPIO_EN_CLR(led_scan_blank_en);
+    LED_GPIO_OUT_CLR(out_clr);
+    LED_GPIO_OUT_SET(out_set);
+    LED_GPIO_EN_SET(en_set);
+  #endif
+    
+    if(++row >= LED_SCAN_ROWS) {
+      row = 0;
+      led_scan_frames = led_scan_frames + 1;
+    }
+    led_scan_row = row;
+    
+    uint32_t cycles = LED_BUILTIN_FAST_CLOCK() - start;
+    led_scan_isr_count = led_scan_isr_count + 1;
+    led_scan_isr_cycles = led_scan_isr_cycles + cycles;
+    if(cycles > led_scan_isr_max) led_scan_isr_max = cycles;
+  }
+
+  // Recalcule les masques de toutes les lignes depuis le framebuffer
+  static void led_scan_build(void) {
+    for(uint8_t r = 0; r < LED_SCAN_ROWS; r++) {
+      LED_ScanRow_t* row = &led_scan_back[r];
+      row->out_clr = 0;
+      row->out_set = 0;
+      row->en_set = 0;
+  #if defined(LED_BUILTIN_BACKEND_MATRIX)
+      for(uint8_t i = 0; i < LED_SCAN_ROWS; i++) {
+        uint32_t bit = 1UL << led_scan_row_pin[i];
+        if((i == r) == (LED_MATRIX_ROW_ACTIVE_HIGH != 0)) row->out_set |= bit;
+        else row->out_clr |= bit;
+      }
+      for(uint8_t c = 0; c < LED_SCAN_COLS; c++) {
+        uint16_t led = r * LED_SCAN_COLS + c;
+        bool on = (led_scan_fb[led / 8] >> (led & 7)) & 1;
+        uint32_t bit = 1UL << led_scan_col_pin[c];
+        if(on == (LED_MATRIX_COL_ACTIVE_HIGH != 0)) row->out_set |= bit;
+        else row->out_clr |= bit;
+      }
+  #else
+      // Anode HIGH, cathodes LOW ; seules les broches des LED allumées sont sorties
+      row->out_set = 1UL << led_scan_row_pin[r];
+      row->en_set = row->out_set;
+      for(uint8_t c = 0; c < LED_SCAN_COLS; c++) {
+        uint16_t led = r * LED_SCAN_COLS + c;
+        uint32_t bit = 1UL << led_scan_row_pin[c < r ? c : c + 1];
+        row->out_clr |= bit;
+        if((led_scan_fb[led / 8] >> (led & 7)) & 1) row->en_set |= bit;
+      }
+  #endif
+    }
+  }
+
+  static inline void led_backend_write(uint16_t ch, bool on) {
+    uint16_t led = ch - 1;
+    uint8_t* byte = &led_scan_fb[led / 8];
+    uint8_t mask = (uint8_t)(1 << (led & 7));
+    uint8_t value = on ? (uint8_t)(*byte | mask) : (uint8_t)(*byte & ~mask);
+    if(value != *byte) {
+      *byte = value;
+      led_scan_dirty = true;
+    }
+  }
+
+  /**
+   * @brief Publie le framebuffer vers l'ISR s'il a changé
+   */
+  static void led_backend_flush(void) {
+    if(!led_scan_dirty) return;
+    led_scan_build();
+    LED_ISR_LOCK();
+    for(uint8_t r = 0; r < LED_SCAN_ROWS; r++) {
+      led_scan_front[r].out_clr = led_scan_back[r].out_clr;
+      led_scan_front[r].out_set = led_scan_back[r].out_set;
+      led_scan_front[r].en_set = led_scan_back[r].en_set;
+    }
+    LED_ISR_UNLOCK();
+    led_scan_dirty = false;
+  }
+
+  void LED_SCAN_STOP(void) {
+    if(!led_scan_running) return;
+    led_timer_end();
+    LED_GPIO_OUT_CLR(led_scan_blank_clr);
+    LED_GPIO_OUT_SET(led_scan_blank_set);
+    LED_GPIO_EN_CLR(led_scan_blank_en);
+    led_scan_running = false;
+  }
+
+  // Démarre le timer de balayage : une interruption par ligne
+  static bool led_scan_start(uint16_t refresh_hz) {
+    uint32_t row_hz = (uint32_t)refresh_hz * LED_SCAN_ROWS;
+    if(row_hz == 0) return false;
+    uint32_t row_ticks = LED_TIMER_HZ / row_hz;
+    if(row_ticks < LED_SCAN_MIN_TICKS) return false;
+    
+    led_scan_dirty = true;
+    led_backend_flush();
+    led_scan_row = 0;
+    led_scan_frames = 0;
+    led_scan_isr_count = 0;
+    led_scan_isr_cycles = 0;
+    led_scan_isr_max = 0;
+    led_scan_stats_since = micros();
+    
+    if(!led_timer_begin(led_scan_isr, row_ticks, false)) return false;
+    led_scan_running = true;
+    return true;
+  }
+
+  #if defined(LED_BUILTIN_BACKEND_MATRIX)
+  bool LED_MATRIX_BEGIN(const uint8_t* row_pins, const uint8_t* col_pins, uint16_t refresh_hz) {
+    LED_SCAN_STOP();
+    led_scan_blank_clr = 0;
+    led_scan_blank_set = 0;
+    for(uint8_t r = 0; r < LED_SCAN_ROWS; r++) {
+      if(row_pins[r] >= LED_GPIO_FAST_MAX) return false;
+      led_scan_row_pin[r] = row_pins[r];
+      if(LED_MATRIX_ROW_ACTIVE_HIGH) led_scan_blank_clr |= 1UL << row_pins[r];
+      else led_scan_blank_set |= 1UL << row_pins[r];
+    }
+    for(uint8_t c = 0; c < LED_SCAN_COLS; c++) {
+      if(col_pins[c] >= LED_GPIO_FAST_MAX) return false;
+      led_scan_col_pin[c] = col_pins[c];
+    }
+    LED_GPIO_OUT_CLR(led_scan_blank_clr);
+    LED_GPIO_OUT_SET(led_scan_blank_set);
+    for(uint8_t r = 0; r < LED_SCAN_ROWS; r++) pinMode(row_pins[r], OUTPUT);
+    for(uint8_t c = 0; c < LED_SCAN_COLS; c++) pinMode(col_pins[c], OUTPUT);
+    led_scan_blank_en = 0;
+    return led_scan_start(refresh_hz);
+  }
+  #else
+  bool LED_CHARLIEPLEX_BEGIN(const uint8_t* pins, uint16_t refresh_hz) {
+    LED_SCAN_STOP();
+    led_scan_blank_en = 0;
+    for(uint8_t p = 0; p < LED_SCAN_ROWS; p++) {
+      if(pins[p] >= LED_GPIO_FAST_MAX) return false;
+      led_scan_row_pin[p] = pins[p];
+      led_scan_blank_en |= 1UL << pins[p];
+    }
+    // Broches configurées en GPIO puis laissées en haute impédance
+    for(uint8_t p = 0; p < LED_SCAN_ROWS; p++) pinMode(pins[p], OUTPUT);
+    LED_GPIO_EN_CLR(led_scan_blank_en);
+    led_scan_blank_clr = 0;
+    led_scan_blank_set = 0;
+    return led_scan_start(refresh_hz);
+  }
+  #endif
+
+  void LED_SCAN_GET_STATS(LED_ScanStats_t* stats) {
+    uint32_t now = micros();
+    LED_ISR_LOCK();
+    uint32_t frames = led_scan_frames;
+    uint32_t count = led_scan_isr_count;
+    uint32_t cycles = led_scan_isr_cycles;
+    uint32_t max_cycles = led_scan_isr_max;
+    led_scan_frames = 0;
+    led_scan_isr_count = 0;
+    led_scan_isr_cycles = 0;
+    led_scan_isr_max = 0;
+    LED_ISR_UNLOCK();
+    
+    uint32_t elapsed_us = now - led_scan_stats_since;
+    led_scan_stats_since = now;
+    float cycles_per_us = (float)LED_BUILTIN_FAST_CLOCK_PER_US();
+    
+    stats->refresh_hz = elapsed_us ? frames * 1000000.0f / elapsed_us : 0.0f;
+    stats->isr_count = count;
+    stats->isr_avg_us = count ? cycles / cycles_per_us / count : 0.0f;
+    stats->isr_max_us = max_cycles / cycles_per_us;
+    stats->cpu_load = elapsed_us ? cycles / cycles_per_us * 100.0f / elapsed_us : 0.0f;
+  }
+
+#elif defined(LED_BUILTIN_BACKEND_BCM)
+  // ------------------------------------------------------------
+  // Gradation BCM (Binary Code Modulation) sur GPIO simples
+  // ------------------------------------------------------------
+  #ifndef LED_BCM_ACTIVE_HIGH
+    #define LED_BCM_ACTIVE_HIGH 1   // 1 = HIGH allume la LED
+  #endif
+  #ifndef LED_BCM_MIN_TICKS
+    #define LED_BCM_MIN_TICKS (LED_TIMER_HZ / 100000UL)   // plan le plus court : 10 µs
+  #endif
+  #define LED_BCM_LEDS (LED_CHANNEL_COUNT - 1)
+
+  static uint8_t led_bcm_pin[LED_BCM_LEDS];
+  static uint8_t led_bcm_level[LED_BCM_LEDS];   // luminosité à l'état ON (0-255)
+  static uint8_t led_bcm_on[(LED_BCM_LEDS + 7) / 8];
+  static bool led_bcm_dirty = false;
+  static bool led_bcm_running = false;
+  static bool led_bcm_level_set = false;        // luminosités initialisées à 255
+
+  static uint32_t led_bcm_back_set[LED_BCM_BITS];            // construits par loop()
+  static uint32_t led_bcm_back_clr[LED_BCM_BITS];
+  static volatile uint32_t led_bcm_set[LED_BCM_BITS];        // lus par l'ISR
+  static volatile uint32_t led_bcm_clr[LED_BCM_BITS];
+  static uint32_t led_bcm_ticks[LED_BCM_BITS];               // durée de chaque plan
+  static uint32_t led_bcm_all = 0;                           // toutes les broches BCM
+  static volatile uint8_t led_bcm_plane = 0;
+
+  static void IRAM_ATTR led_bcm_isr(void) {
+    uint8_t plane = led_bcm_plane;
+    
+    LED_ISR_LOCK_ISR();
+    uint32_t clr = led_bcm_clr[plane];
+    uint32_t set = led_bcm_set[plane];
+    LED_ISR_UNLOCK_ISR();
+    
+    LED_GPIO_OUT_CLR(clr);
+    LED_GPIO_OUT_SET(set);
+    led_timer_rearm(led_bcm_ticks[plane]);
+    led_bcm_plane = (plane + 1 < LED_BCM_BITS) ? plane + 1 : 0;
+  }
+
+  static inline void led_backend_write(uint16_t ch, bool on) {
+    uint16_t led = ch - 1;
+    uint8_t* byte = &led_bcm_on[led / 8];
+    uint8_t mask = (uint8_t)(1 << (led & 7));
+    uint8_t value = on ? (uint8_t)(*byte | mask) : (uint8_t)(*byte & ~mask);
+    if(value != *byte) {
+      *byte = value;
+      led_bcm_dirty = true;
+    }
+  }
+
+  /**
+   * @brief Recalcule les masques des plans de bits et les publie vers l'ISR
+   */
+  static void led_backend_flush(void) {
+    if(!led_bcm_dirty) return;
+    
+    for(uint8_t b = 0; b < LED_BCM_BITS; b++) {
+      led_bcm_back_set[b] = 0;
+    }
+    for(uint16_t led = 0; led < LED_BCM_LEDS; led++) {
+      if(!((led_bcm_on[led / 8] >> (led & 7)) & 1)) continue;
+      uint8_t code = led_bcm_level[led] >> (8 - LED_BCM_BITS);
+      uint32_t bit = 1UL << led_bcm_pin[led];
+      for(uint8_t b = 0; b < LED_BCM_BITS; b++) {
+        if((code >> b) & 1) led_bcm_back_set[b] |= bit;
+      }
+    }
+    for(uint8_t b = 0; b < LED_BCM_BITS; b++) {
+      // Plans calculés en "LED allumée" puis traduits selon la polarité
+      led_bcm_back_clr[b] = led_bcm_all & ~led_bcm_back_set[b];
+      if(!LED_BCM_ACTIVE_HIGH) {
+        uint32_t lit = led_bcm_back_set[b];
+        led_bcm_back_set[b] = led_bcm_back_clr[b];
+        led_bcm_back_clr[b] = lit;
+      }
+    }
+    
+    LED_ISR_LOCK();
+    for(uint8_t b = 0; b < LED_BCM_BITS; b++) {
+      led_bcm_set[b] = led_bcm_back_set[b];
+      led_bcm_clr[b] = led_bcm_back_clr[b];
+    }
+    LED_ISR_UNLOCK();
+    led_bcm_dirty = false;
+  }
+
+  // Pleine luminosité par défaut, une seule fois : les réglages faits avant
+  // LED_BCM_BEGIN() ou entre deux redémarrages sont conservés
+  static void led_bcm_level_init(void) {
+    if(led_bcm_level_set) return;
+    memset(led_bcm_level, 255, sizeof(led_bcm_level));
+    led_bcm_level_set = true;
+  }
+
+  void LED_CHANNEL_SET_BRIGHTNESS(uint16_t ch, uint8_t level) {
+    if(ch == 0 || ch >= LED_CHANNEL_COUNT) return;
+    led_bcm_level_init();
+    uint16_t led = ch - 1;
+    if(led_bcm_level[led] == level) return;
+    led_bcm_level[led] = level;
+    if((led_bcm_on[led / 8] >> (led & 7)) & 1) {
+      led_bcm_dirty = true;
+      led_backend_flush();
+    }
+  }
+
+  void LED_BCM_STOP(void) {
+    if(!led_bcm_running) return;
+    led_timer_end();
+    if(LED_BCM_ACTIVE_HIGH) LED_GPIO_OUT_CLR(led_bcm_all);
+    else LED_GPIO_OUT_SET(led_bcm_all);
+    led_bcm_running = false;
+  }
+
+  bool LED_BCM_BEGIN(const uint8_t* pins, uint16_t refresh_hz) {
+    LED_BCM_STOP();
+    if(refresh_hz == 0) return false;
+    uint32_t lsb_ticks = LED_TIMER_HZ / refresh_hz / ((1UL << LED_BCM_BITS) - 1);
+    if(lsb_ticks < LED_BCM_MIN_TICKS) return false;
+    // Toutes les broches sont vérifiées avant de modifier la configuration
+    for(uint16_t led = 0; led < LED_BCM_LEDS; led++) {
+      if(pins[led] >= LED_GPIO_FAST_MAX) return false;
+    }
+    
+    led_bcm_level_init();
+    led_bcm_all = 0;
+    for(uint16_t led = 0; led < LED_BCM_LEDS; led++) {
+      led_bcm_pin[led] = pins[led];
+      led_bcm_all |= 1UL << pins[led];
+    }
+    for(uint8_t b = 0; b < LED_BCM_BITS; b++) {
+      led_bcm_ticks[b] = lsb_ticks << b;
+    }
+    
+    if(LED_BCM_ACTIVE_HIGH) LED_GPIO_OUT_CLR(led_bcm_all);
+    else LED_GPIO_OUT_SET(led_bcm_all);
+    for(uint16_t led = 0; led < LED_BCM_LEDS; led++) pinMode(pins[led], OUTPUT);
+    
+    led_bcm_dirty = true;
+    led_backend_flush();
+    led_bcm_plane = 0;
+    if(!led_timer_begin(led_bcm_isr, led_bcm_ticks[0], true)) return false;
+    led_bcm_running = true;
+    return true;
+  }
+
+#else
+  // ------------------------------------------------------------
+  // GPIO : un canal = une broche, attribuée par LED_CHANNEL_ATTACH()
+  // ------------------------------------------------------------
+  #define LED_GPIO_ATTACHED    0x80
+  #define LED_GPIO_ACTIVE_HIGH 0x40
+  #define LED_GPIO_PIN_MASK    0x3F
+
+  static uint8_t led_channel_gpio[LED_CHANNEL_COUNT];   // 0 = canal non attribué
+
+  static inline void led_backend_write(uint16_t ch, bool on) {
+    uint8_t gpio = led_channel_gpio[ch];
+    if(!(gpio & LED_GPIO_ATTACHED)) return;
+    digitalWrite(gpio & LED_GPIO_PIN_MASK, (on == ((gpio & LED_GPIO_ACTIVE_HIGH) != 0)) ? HIGH : LOW);
+  }
+
+  static inline void led_backend_flush(void) {}
+
+  void LED_CHANNEL_ATTACH(uint16_t ch, uint8_t pin, bool active_high) {
+    if(ch == 0 || ch >= LED_CHANNEL_COUNT || pin > LED_GPIO_PIN_MASK) return;
+    led_channel_gpio[ch] = LED_GPIO_ATTACHED | (active_high ? LED_GPIO_ACTIVE_HIGH : 0) | pin;
+    pinMode(pin, OUTPUT);
+    led_backend_write(ch, false);
+  }
+#endif
+
+#endif // LED_CHANNEL_COUNT > 1
+
+// ============================================
+// FONCTIONS DE BASE
+// ============================================
+void LED_BUILTIN_BEGIN_CONFIGURED(uint8_t pin, uint8_t on_state) {
+  led_builtin_pin = pin;
+  led_builtin_on_state = on_state;
+  #ifdef LED_BUILTIN_IS_RGB
+    LED_RGB_INIT();
+    LED_RGB_OFF();
+  #else
+    pinMode(led_builtin_pin, OUTPUT);
+    LED_BUILTIN_OFF();
+  #endif
+}
+
+// Écrit LED_BUILTIN sans tracer : les pas du moteur sont tracés par l'appelant
+static void led_builtin_write(bool on) {
+  #ifdef LED_BUILTIN_IS_RGB
+    if(on) LED_RGB_ON();
+    else LED_RGB_OFF();
+  #else
+    digitalWrite(led_builtin_pin, on ? led_builtin_on_state : (led_builtin_on_state == HIGH ? LOW : HIGH));
+  #endif
+}
+
+void LED_BUILTIN_ON(void) {
+  led_builtin_write(true);
+  LED_TRACE_RECORD_NOW(0, 1, LED_TRACE_INDEX_NONE);
+}
+
+void LED_BUILTIN_OFF(void) {
+  led_builtin_write(false);
+  LED_TRACE_RECORD_NOW(0, 0, LED_TRACE_INDEX_NONE);
+}
+
+void LED_BUILTIN_TOGGLE(void) {
+  #ifdef LED_BUILTIN_IS_RGB
+    // Pour RGB, on alterne entre ON et OFF
+    static bool rgb_state = false;
+    rgb_state = !rgb_state;
+    bool on = rgb_state;
+  #else
+    bool on = digitalRead(led_builtin_pin) != led_builtin_on_state;
+  #endif
+  led_builtin_write(on);
+  LED_TRACE_RECORD_NOW(0, on, LED_TRACE_INDEX_NONE);
+}
+
+// ============================================
+// CANAUX
+// ============================================
+// Écrit l'état d'un canal sans émettre la trame du backend
+static void led_channel_write(uint16_t ch, bool on) {
+  if(ch == 0) {
+    led_builtin_write(on);
+  }
+#if LED_CHANNEL_COUNT > 1
+  else {
+    led_backend_write(ch, on);
+  }
+#endif
+}
+
+static inline void led_channel_flush(void) {
+#if LED_CHANNEL_COUNT > 1
+  led_backend_flush();
+#endif
+}
+
+void LED_CHANNEL_ON(uint16_t ch) {
+  if(ch >= LED_CHANNEL_COUNT) return;
+  led_channel_write(ch, true);
+  LED_TRACE_RECORD_NOW((uint8_t)ch, 1, LED_TRACE_INDEX_NONE);
+  led_channel_flush();
+}
+
+void LED_CHANNEL_OFF(uint16_t ch) {
+  if(ch >= LED_CHANNEL_COUNT) return;
+  led_channel_write(ch, false);
+  LED_TRACE_RECORD_NOW((uint8_t)ch, 0, LED_TRACE_INDEX_NONE);
+  led_channel_flush();
+}
+
+// Passe un canal à LED_STATE_IDLE en tenant le compte des canaux actifs
+static inline void led_channel_idle(LED_Control_t* c) {
+  if(c->state != LED_STATE_IDLE) {
+    c->state = LED_STATE_IDLE;
+    led_active_count--;
+  }
+}
+
+// Active un canal ; sa première transition est échue immédiatement
+static LED_Control_t* led_channel_start(uint16_t ch, LED_State_t state) {
+  LED_Control_t* c = &led_channels[ch];
+  if(c->state == LED_STATE_IDLE) led_active_count++;
+  c->state = state;
+  c->next_time = millis();
+  led_deadline = c->next_time;
+  led_schedule_now();
+  return c;
+}
+
+void LED_CHANNEL_STOP(uint16_t ch) {
+  if(ch >= LED_CHANNEL_COUNT) return;
+  led_channel_idle(&led_channels[ch]);
+  led_channel_write(ch, false);
+  LED_TRACE_RECORD_NOW((uint8_t)ch, 0, LED_TRACE_INDEX_NONE);
+  led_channel_flush();
+}
+
+void LED_BUILTIN_STOP(void) {
+  LED_CHANNEL_STOP(0);
+}
+
+// ============================================
+// FONCTION UPDATE
+// ============================================
+/**
+ * @brief Traite la transition échue d'un canal
+ * @return true si le canal reste actif, false s'il a terminé
+ */
+static bool led_channel_step(uint16_t ch, LED_Control_t* c, unsigned long current_time) {
+  switch(c->state) {
+    case LED_STATE_IDLE:
+      return false;
+      
+    case LED_STATE_BLINK:
+      if(c->led_is_on) {
+        // Passer de ON à OFF
+        led_channel_write(ch, false);
+        LED_TRACE_RECORD((uint8_t)ch, 0, c->current_count);
+        c->led_is_on = false;
+        c->current_count++;
+        
+        // Vérifier si on a terminé
+        if(c->current_count >= c->count) {
+          led_channel_idle(c);
+          return false;
+        }
+        
+        c->next_time = current_time + c->off_time;
+      } else {
+        // Passer de OFF à ON
+        led_channel_write(ch, true);
+        LED_TRACE_RECORD((uint8_t)ch, 1, c->current_count);
+        c->led_is_on = true;
+        c->next_time = current_time + c->on_time;
+      }
+      return true;
+      
+    case LED_STATE_PATTERN:
+#ifndef LED_BUILTIN_NO_PATTERNS
+      // État suivant du pattern
+      led_channel_write(ch, c->pattern[c->pattern_index] == 1);
+      LED_TRACE_RECORD((uint8_t)ch, c->pattern[c->pattern_index] == 1, c->pattern_index);
+      
+      c->next_time = current_time + c->times[c->pattern_index];
+      c->pattern_index++;
+      
+      // Fin du pattern ?
+      if(c->pattern_index >= c->pattern_length) {
+        c->pattern_index = 0;
+        c->pattern_current_repeat++;
+        
+        if(c->pattern_current_repeat >= c->pattern_repeat) {
+          led_channel_write(ch, false);
+          LED_TRACE_RECORD((uint8_t)ch, 0, LED_TRACE_INDEX_NONE);
+          led_channel_idle(c);
+          return false;
+        }
+      }
+      return true;
+#else
+      return false;
+#endif
+  }
+  
+  return false;
+}
+
+/**
+ * @brief Chemin lent de LED_BUILTIN_UPDATE() : traite les transitions échues
+ *
+ * Parcourt tous les canaux actifs, recalcule l'échéance la plus proche,
+ * puis émet la trame du backend une seule fois si elle a changé.
+ * @return true si une animation est en cours, false sinon
+ */
+LED_BUILTIN_NOINLINE bool LED_BUILTIN_UPDATE_DUE(void) {
+  unsigned long current_time = millis();
+  led_pass_clock = LED_BUILTIN_FAST_CLOCK();
+  led_pass_us = micros();
+  
+  // Échéance rapide atteinte avant millis() (horizon ou arrondi) : on replanifie
+  if((long)(current_time - led_deadline) >= 0) {
+    bool first = true;
+    for(uint16_t ch = 0; ch < LED_CHANNEL_COUNT; ch++) {
+      LED_Control_t* c = &led_channels[ch];
+      if(c->state == LED_STATE_IDLE) continue;
+      if((long)(current_time - c->next_time) >= 0 && !led_channel_step(ch, c, current_time)) continue;
+      if(first || (long)(c->next_time - led_deadline) < 0) {
+        led_deadline = c->next_time;
+        first = false;
+      }
+    }
+    led_channel_flush();
+  }
+  
+  if(led_active_count == 0) return false;
+  led_schedule();
+  return true;
+}
+
+// ============================================
+// FONCTIONS DE DÉMARRAGE DE SÉQUENCES
+// ============================================
+void LED_CHANNEL_BLINK_START(uint16_t ch, uint16_t on_time_ms, uint16_t off_time_ms, uint8_t count) {
+  if(ch >= LED_CHANNEL_COUNT) return;
+  LED_Control_t* c = led_channel_start(ch, LED_STATE_BLINK);
+  c->on_time = on_time_ms;
+  c->off_time = off_time_ms;
+  c->count = count;
+  c->current_count = 0;
+  c->led_is_on = false;
+}
+
+#ifndef LED_BUILTIN_NO_PATTERNS
+void LED_CHANNEL_PATTERN_START(uint16_t ch, const uint8_t* pattern, const uint16_t* times, uint8_t length, uint8_t repeat) {
+  if(ch >= LED_CHANNEL_COUNT) return;
+  LED_Control_t* c = led_channel_start(ch, LED_STATE_PATTERN);
+  c->pattern = pattern;
+  c->times = times;
+  c->pattern_length = length;
+  c->pattern_index = 0;
+  c->pattern_repeat = repeat;
+  c->pattern_current_repeat = 0;
+}
+#endif
+
+bool LED_CHANNEL_IS_ACTIVE(uint16_t ch) {
+  return ch < LED_CHANNEL_COUNT && led_channels[ch].state != LED_STATE_IDLE;
+}
+
+const LED_Control_t* LED_CHANNEL_GET_CONTROL(uint16_t ch) {
+  return ch < LED_CHANNEL_COUNT ? &led_channels[ch] : nullptr;
+}
+
+void LED_BUILTIN_BLINK_START(uint16_t delay_ms, uint8_t count) {
+  LED_CHANNEL_BLINK_START(0, delay_ms, delay_ms, count);
+}
+
+void LED_BUILTIN_BLINK_TIMING_START(uint16_t on_time_ms, uint16_t off_time_ms, uint8_t count) {
+  LED_CHANNEL_BLINK_START(0, on_time_ms, off_time_ms, count);
+}
+
+#ifndef LED_BUILTIN_NO_FLOAT_API
+void LED_BUILTIN_BLINK_DUTY_START(uint16_t period_ms, float duty_cycle, uint8_t count) {
+  if(duty_cycle < 0.0f) duty_cycle = 0.0f;
+  if(duty_cycle > 1.0f) duty_cycle = 1.0f;
+  
+  uint16_t on_time = (uint16_t)(period_ms * duty_cycle);
+  LED_CHANNEL_BLINK_START(0, on_time, period_ms - on_time, count);
+}
+
+void LED_BUILTIN_BLINK_FREQ_START(float freq_hz, float duty_cycle, uint16_t duration_ms) {
+  if(freq_hz <= 0.0f) return;
+  if(duty_cycle < 0.0f) duty_cycle = 0.0f;
+  if(duty_cycle > 1.0f) duty_cycle = 1.0f;
+  
+  uint16_t period_ms = (uint16_t)(1000.0f / freq_hz);
+  uint8_t count = (uint8_t)(duration_ms / period_ms);
+  
+  LED_BUILTIN_BLINK_DUTY_START(period_ms, duty_cycle, count);
+}
+#endif
+
+#ifndef LED_BUILTIN_NO_PATTERNS
+void LED_BUILTIN_BLINK_PATTERN_START(const uint8_t* pattern, const uint16_t* times, uint8_t length, uint8_t repeat) {
+  LED_CHANNEL_PATTERN_START(0, pattern, times, length, repeat);
+}
+
+void LED_BUILTIN_SOS_START(void) {
+  // Pattern SOS : ...---...
+  static const uint8_t sos_pattern[] = {
+    1,0, 1,0, 1,0,  // S (3 courts)
+    0,              // Pause
+    1,0, 1,0, 1,0,  // O (3 longs)
+    0,              // Pause
+    1,0, 1,0, 1,0   // S (3 courts)
+  };
+  
+  static const uint16_t sos_times[] = {
+    200,200, 200,200, 200,300,  // S
+    300,                        // Pause
+    600,200, 600,200, 600,300,  // O
+    300,                        // Pause
+    200,200, 200,200, 200,1000  // S + pause finale
+  };
+  
+  LED_BUILTIN_BLINK_PATTERN_START(sos_pattern, sos_times, 19, 1);
+}
+#endif
+
+bool LED_BUILTIN_IS_ACTIVE(void) {
+  return LED_CHANNEL_IS_ACTIVE(0);
+}
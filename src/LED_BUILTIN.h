@@ -1,6 +1,6 @@
 //  --------------------------------------------------------------------------
 //  LED_BUILTIN.h  –  Gestion non-bloquante des LED intégrées ESP8266 / ESP32
-//  Version 2.3.2
+//  Version 3.0.0
 //  --------------------------------------------------------------------------
 //  ☞  APPELER  LED_BUILTIN_UPDATE()  DANS  loop()  !
 //  --------------------------------------------------------------------------
@@ -32,6 +32,18 @@
 #define LED_BUILTIN_H
 #include <Arduino.h>
 
+#define LED_BUILTIN_VERSION_STRING "3.0.0"
+
+// Options du moteur communes au sketch et à la bibliothèque (voir
+// « SÉLECTION DES FONCTIONNALITÉS »), à défaut de build_flags. Cherché
+// d'abord à côté de ce fichier (src/ de la bibliothèque), puis dans les
+// chemins -I : le dossier du sketch n'est pas visible depuis la bibliothèque.
+#if defined(__has_include)
+  #if __has_include("LED_BUILTIN_config.h")
+    #include "LED_BUILTIN_config.h"
+  #endif
+#endif
+
 // ----------------------------------------------------------
 // Détection de la plate-forme
 // ----------------------------------------------------------
@@ -220,8 +232,11 @@
   #endif
 // ----------------------------------------------------------
 //  Heltec WiFi Kit 32 V3  ––  choix obligatoire - LED blanche – NON INVERSÉE
+//  (choix fait dans le sketch : la bibliothèque reçoit la broche par
+//  ENABLE_LED_BUILTIN() et n'en a pas besoin à la compilation)
 // ----------------------------------------------------------
-#if defined(ARDUINO_HELTEC_WIFI_KIT_32_V3) || defined(ARDUINO_HELTEC_WIFI_LORA_32_V3)
+#if (defined(ARDUINO_HELTEC_WIFI_KIT_32_V3) || defined(ARDUINO_HELTEC_WIFI_LORA_32_V3)) && \
+    !defined(LED_BUILTIN_LIBRARY_BUILD)
   #if !defined(HELTEC_V3_LED_GPIO35) && !defined(HELTEC_V3_LED_GPIO38)
     #error "Heltec V3 board detected : please define either HELTEC_V3_LED_GPIO35 or HELTEC_V3_LED_GPIO38 before including LED_BUILTIN.h"
   #endif
@@ -390,8 +405,9 @@
   #endif
   // ----------------------------------------------------------
 //  ESP32-C6  ––  choix obligatoire - LED RGB – NON INVERSÉE
+//  (choix fait dans le sketch, comme pour Heltec V3)
 // ----------------------------------------------------------
-#if defined(ARDUINO_ESP32_C6_DEV)
+#if defined(ARDUINO_ESP32_C6_DEV) && !defined(LED_BUILTIN_LIBRARY_BUILD)
   #if !defined(ESP32_C6_LED_GPIO8) && !defined(ESP32_C6_LED_GPIO18)
     #error "ESP32-C6 board detected : please define either ESP32_C6_LED_GPIO8 or ESP32_C6_LED_GPIO18 before including LED_BUILTIN.h"
   #endif
@@ -442,14 +458,37 @@
   #define LED_OFF_STATE  LOW
 #endif
 
+// ============================================
+// SÉLECTION DES FONCTIONNALITÉS
+// ============================================
+// Le moteur est compilé une seule fois, dans src/LED_BUILTIN.cpp. Ses
+// options doivent donc être vues à l'identique par ce fichier et par le
+// sketch : les définir dans build_flags (platformio.ini) ou dans
+// LED_BUILTIN_config.h, jamais seulement avant l'include du sketch.
+// Une configuration différente entre les deux fait échouer l'édition de
+// liens sur led_builtin_begin_c<canaux>_b<backend>_t<trace>_f<float>_p<motifs>_r<rgb>.
+//
+//   LED_CHANNEL_COUNT           nombre de canaux (entier littéral, défaut : 1)
+//   LED_BUILTIN_BACKEND_xxx     backend des canaux 1..N (voir plus bas)
+//   LED_BUILTIN_TRACE           trace des transitions
+//   LED_BUILTIN_NO_FLOAT_API    retire BLINK_DUTY / BLINK_FREQ (aucun calcul flottant)
+//   LED_BUILTIN_NO_PATTERNS     retire les motifs et le SOS (et leurs champs par canal)
+//   LED_BUILTIN_NO_RGB          ignore la LED RGB (Adafruit NeoPixel n'est pas lié)
+//
+// LED_BUILTIN, LED_BUILTIN_POLARITY et LED_BUILTIN_COMPATIBILITY_MODE
+// restent réglables depuis le sketch.
+
 // ============================================
 // GESTION LED RGB (M5Stack ATOM, etc.)
-// n’oublie pas que l’adresse du pixel est 0 (pas 1) 
+// n’oublie pas que l’adresse du pixel est 0 (pas 1)
 // ============================================
+#if defined(LED_BUILTIN_IS_RGB) && defined(LED_BUILTIN_NO_RGB)
+  #undef LED_BUILTIN_IS_RGB
+#endif
+
 #ifdef LED_BUILTIN_IS_RGB
   // Vérifier si Adafruit_NeoPixel est disponible
   #if __has_include(<Adafruit_NeoPixel.h>)
-    #include <Adafruit_NeoPixel.h>
     #define LED_RGB_AVAILABLE
   #else
     #warning "LED RGB détectée mais Adafruit_NeoPixel n'est pas installé. Installez la bibliothèque Adafruit NeoPixel pour utiliser les fonctions RGB."
@@ -458,23 +497,12 @@
 #endif
 
 #ifdef LED_RGB_AVAILABLE
-  
-  static Adafruit_NeoPixel* led_rgb_strip = nullptr;
-  static uint8_t led_rgb_r = 255, led_rgb_g = 255, led_rgb_b = 255;
-  static uint8_t led_rgb_brightness = 50; // 0-255
-  
+
   /**
    * @brief Initialise la LED RGB
    */
-  void LED_RGB_INIT() {
-    if(led_rgb_strip == nullptr) {
-      led_rgb_strip = new Adafruit_NeoPixel(1, LED_BUILTIN, NEO_GRB + NEO_KHZ800);
-      led_rgb_strip->begin();
-      led_rgb_strip->setBrightness(led_rgb_brightness);
-      led_rgb_strip->show();
-    }
-  }
-  
+  void LED_RGB_INIT(void);
+
   /**
    * @brief Définit la couleur de la LED RGB
    * @param r Rouge (0-255)
@@ -482,35 +510,18 @@
    * @param b Bleu (0-255)
    * @param brightness Luminosité (0-255, optionnel)
    */
-  void LED_RGB_SET_COLOR(uint8_t r, uint8_t g, uint8_t b, uint8_t brightness = 255) {
-    LED_RGB_INIT();
-    led_rgb_r = r;
-    led_rgb_g = g;
-    led_rgb_b = b;
-    if(brightness < 255) {
-      led_rgb_brightness = brightness;
-      led_rgb_strip->setBrightness(brightness);
-    }
-  }
-  
+  void LED_RGB_SET_COLOR(uint8_t r, uint8_t g, uint8_t b, uint8_t brightness = 255);
+
   /**
    * @brief Allume la LED RGB avec la couleur définie
    */
-  void LED_RGB_ON() {
-    LED_RGB_INIT();
-    led_rgb_strip->setPixelColor(0, led_rgb_strip->Color(led_rgb_r, led_rgb_g, led_rgb_b));
-    led_rgb_strip->show();
-  }
-  
+  void LED_RGB_ON(void);
+
   /**
    * @brief Éteint la LED RGB
    */
-  void LED_RGB_OFF() {
-    LED_RGB_INIT();
-    led_rgb_strip->setPixelColor(0, 0);
-    led_rgb_strip->show();
-  }
-  
+  void LED_RGB_OFF(void);
+
   // Couleurs prédéfinies
   #define LED_RGB_RED()     LED_RGB_SET_COLOR(255, 0, 0)
   #define LED_RGB_GREEN()   LED_RGB_SET_COLOR(0, 255, 0)
@@ -526,6 +537,19 @@
 // ============================================
 // STRUCTURE DE GESTION D'ÉTAT
 // ============================================
+// Nombre de canaux animés indépendamment. Le canal 0 est toujours
+// LED_BUILTIN ; les canaux 1 à LED_CHANNEL_COUNT-1 sont routés vers le
+// backend de sortie (GPIO par défaut, registres à décalage 74HC595 avec
+// LED_BUILTIN_BACKEND_SHIFTREG, matrice balayée par timer avec
+// LED_BUILTIN_BACKEND_MATRIX ou LED_BUILTIN_BACKEND_CHARLIEPLEX, gradation
+// BCM avec LED_BUILTIN_BACKEND_BCM).
+#ifndef LED_CHANNEL_COUNT
+  #define LED_CHANNEL_COUNT 1
+#endif
+#if LED_CHANNEL_COUNT < 1 || LED_CHANNEL_COUNT > 256
+  #error "LED_CHANNEL_COUNT must be between 1 and 256"
+#endif
+
 typedef enum {
   LED_STATE_IDLE,
   LED_STATE_BLINK,
@@ -534,14 +558,14 @@ typedef enum {
 
 typedef struct {
   LED_State_t state;
-  unsigned long last_time;
   unsigned long next_time;
   uint16_t on_time;
   uint16_t off_time;
   uint8_t count;
   uint8_t current_count;
   bool led_is_on;
-  
+
+#ifndef LED_BUILTIN_NO_PATTERNS
   // Pour les patterns
   const uint8_t* pattern;
   const uint16_t* times;
@@ -549,125 +573,425 @@ typedef struct {
   uint8_t pattern_index;
   uint8_t pattern_repeat;
   uint8_t pattern_current_repeat;
+#endif
 } LED_Control_t;
 
-static LED_Control_t led_ctrl = {LED_STATE_IDLE, 0, 0, 0, 0, 0, 0, false, nullptr, nullptr, 0, 0, 0, 0};
+// ============================================
+// HORLOGE RAPIDE DU CHEMIN CRITIQUE
+// ============================================
+// LED_BUILTIN_UPDATE() ne lit pas millis() à chaque appel : il compare le
+// compteur de cycles CPU (une seule instruction sur Xtensa / RISC-V) à
+// l'échéance la plus proche, mise en cache en cycles par le moteur.
+// millis() n'est lu que lorsque cette échéance est atteinte.
+// Limites de l'horloge par défaut (ESP.getCycleCount()) :
+//   • la fréquence est lue à la planification : après un changement de
+//     fréquence CPU, l'échéance en cours est décalée dans le rapport des
+//     fréquences ; appelez LED_BUILTIN_RESCHEDULE() juste après
+//     setCpuFrequencyMhz() ;
+//   • sur ESP32 le compteur est propre à chaque cœur : LED_BUILTIN_UPDATE()
+//     doit toujours être appelé depuis le même cœur.
+#ifndef LED_BUILTIN_FAST_CLOCK
+  #define LED_BUILTIN_FAST_CLOCK()         ESP.getCycleCount()
+  #define LED_BUILTIN_FAST_CLOCK_PER_US()  ESP.getCpuFreqMHz()
+  #define LED_BUILTIN_CFG_CLOCK 0
+#endif
+
+#if defined(__GNUC__)
+  #define LED_BUILTIN_ALWAYS_INLINE inline __attribute__((always_inline))
+  #define LED_BUILTIN_NOINLINE      __attribute__((noinline))
+#else
+  #define LED_BUILTIN_ALWAYS_INLINE inline
+  #define LED_BUILTIN_NOINLINE
+#endif
+
+// État partagé avec le chemin rapide inline (défini dans src/LED_BUILTIN.cpp)
+extern uint16_t led_active_count;   // canaux hors LED_STATE_IDLE
+extern uint32_t led_sched_clock;    // horloge rapide lors de la planification
+extern uint32_t led_sched_delta;    // délai jusqu'à l'échéance la plus proche (borné)
 
 // ============================================
-// FONCTIONS DE BASE
+// TRACE DES TRANSITIONS (optionnelle)
 // ============================================
-void ENABLE_LED_BUILTIN(void) {
-  #ifdef LED_BUILTIN_IS_RGB
-    LED_RGB_INIT();
-    LED_RGB_OFF();
-  #else
-    pinMode(LED_BUILTIN, OUTPUT);
-    digitalWrite(LED_BUILTIN, LED_OFF_STATE);
+// LED_BUILTIN_TRACE (build_flags) enregistre chaque transition de sortie
+// dans un tampon circulaire de taille fixe (LED_BUILTIN_TRACE_SIZE
+// entrées, puissance de 2). L'écriture se limite à un incrément d'index,
+// un masque et quatre stores : l'horodatage est le micros() lu une seule
+// fois par passage du chemin lent, commun à toutes ses transitions. Les plus
+// anciennes entrées sont écrasées quand le tampon est plein.
+#ifdef LED_BUILTIN_TRACE
+
+  #ifndef LED_BUILTIN_TRACE_SIZE
+    #define LED_BUILTIN_TRACE_SIZE 256
   #endif
-}
+  #if LED_BUILTIN_TRACE_SIZE < 1 || (LED_BUILTIN_TRACE_SIZE & (LED_BUILTIN_TRACE_SIZE - 1)) != 0
+    #error "LED_BUILTIN_TRACE_SIZE must be a power of 2"
+  #endif
+  #if LED_BUILTIN_TRACE_SIZE > 32768
+    #error "LED_BUILTIN_TRACE_SIZE must not exceed 32768 (entry count is exported as u16)"
+  #endif
+
+  #define LED_TRACE_INDEX_NONE 0xFF   // transition hors séquence (ON / OFF / TOGGLE manuels, STOP)
+
+  typedef struct {
+    uint32_t time_us;   // micros() du passage qui a exécuté la transition
+    uint8_t channel;    // canal de sortie (0 = LED_BUILTIN)
+    uint8_t level;      // 1 = ON, 0 = OFF
+    uint8_t index;      // index dans le pattern / numéro de cycle du blink
+    uint8_t reserved;
+  } LED_Trace_t;
+
+  /**
+   * @brief Vide la trace
+   */
+  void LED_BUILTIN_TRACE_CLEAR(void);
+
+  /**
+   * @brief Nombre d'entrées disponibles dans la trace
+   */
+  uint16_t LED_BUILTIN_TRACE_COUNT(void);
+
+  /**
+   * @brief Nombre de transitions perdues (écrasées avant export)
+   */
+  uint32_t LED_BUILTIN_TRACE_DROPPED(void);
+
+  /**
+   * @brief Exporte la trace au format VCD (GTKWave) sur un flux texte
+   * @param out Flux de sortie (Serial, ...)
+   *
+   * Par canal présent dans la trace : un signal 1 bit "ledN" (niveau) et un
+   * vecteur 8 bits "indexN" (index de pattern / cycle). Le temps est
+   * relatif à la plus ancienne entrée, en microsecondes.
+   */
+  void LED_BUILTIN_TRACE_DUMP_VCD(Print& out);
+
+  /**
+   * @brief Exporte la trace au format binaire compact
+   * @param out Flux de sortie (Serial, ...)
+   *
+   * En-tête "LEDT", version (1 octet), taille d'entrée (1 octet), nombre
+   * d'entrées (uint16 LE), transitions perdues (uint32 LE), puis les
+   * entrées brutes LED_Trace_t (little-endian), de la plus ancienne à la
+   * plus récente. Voir extras/led_trace_vcd.py pour la conversion en VCD.
+   */
+  void LED_BUILTIN_TRACE_DUMP_BINARY(Print& out);
+
+#endif // LED_BUILTIN_TRACE
+
+// ============================================
+// BACKENDS DE SORTIE DES CANAUX 1..N
+// ============================================
+#if LED_CHANNEL_COUNT > 1
+
+#if (defined(LED_BUILTIN_BACKEND_SHIFTREG) + defined(LED_BUILTIN_BACKEND_MATRIX) + \
+     defined(LED_BUILTIN_BACKEND_CHARLIEPLEX) + defined(LED_BUILTIN_BACKEND_BCM)) > 1
+  #error "Choose only one output backend"
+#endif
+
+#if defined(LED_BUILTIN_BACKEND_SHIFTREG)
+  // ------------------------------------------------------------
+  // Registres à décalage chaînés (74HC595 ou équivalent) sur SPI.
+  // Une trame (1 bit par canal) est tenue en RAM ; elle n'est émise
+  // qu'une fois par passe de LED_BUILTIN_UPDATE(), et seulement si au
+  // moins un bit a changé. Canal 1 = Q0 du premier registre (le plus
+  // proche du MCU), canal 9 = Q0 du deuxième, etc.
+  // ESP32 : transfert DMA non bloquant, la broche latch (RCLK) est pilotée
+  //         par le CS matériel du SPI (front montant en fin de trame).
+  //         LED_SHIFTREG_DMA_CH : canal DMA (défaut : automatique à partir
+  //         d'ESP-IDF 4.3, canal 1 avant). Si la trame précédente n'est pas
+  //         terminée après LED_SHIFTREG_WAIT_TICKS ticks (défaut : 1), la
+  //         passe est abandonnée et comptée par LED_SHIFTREG_DROPPED().
+  // ESP8266 : HSPI (MOSI = GPIO 13, SCK = GPIO 14), transfert FIFO.
+  // LED_SHIFTREG_POLARITY : 1 = sortie HIGH allume la LED (défaut), 0 = LED en puits.
+  // ------------------------------------------------------------
+  #define LED_BUILTIN_CFG_BACKEND 1
 
-void LED_BUILTIN_ON(void) {
-  #ifdef LED_BUILTIN_IS_RGB
-    LED_RGB_ON();
+  /**
+   * @brief Initialise la chaîne de registres à décalage et éteint toutes les sorties
+   * @param latch_pin Broche reliée à RCLK (latch) des registres
+   * @param spi_hz Fréquence SPI (défaut : 8 MHz)
+   * @param data_pin Broche DATA / MOSI (ESP32 uniquement, défaut : MOSI)
+   * @param clock_pin Broche horloge / SCK (ESP32 uniquement, défaut : SCK)
+   * @return true si le bus SPI a pu être initialisé
+   */
+  bool LED_SHIFTREG_BEGIN(uint8_t latch_pin, uint32_t spi_hz = 8000000, int8_t data_pin = -1, int8_t clock_pin = -1);
+
+  /**
+   * @brief Nombre de passes où la trame n'a pas pu être émise (bus SPI occupé
+   *        ou bloqué) ; elle repart à la passe suivante. Toujours 0 sur ESP8266.
+   */
+  uint32_t LED_SHIFTREG_DROPPED(void);
+
+#elif defined(LED_BUILTIN_BACKEND_MATRIX) || defined(LED_BUILTIN_BACKEND_CHARLIEPLEX)
+  // ------------------------------------------------------------
+  // Matrice multiplexée lignes / colonnes ou charlieplexing, balayée par
+  // une interruption timer : l'affichage ne dépend pas de la régularité
+  // de loop(). Les canaux écrivent dans un framebuffer (1 bit par LED) ;
+  // à chaque passe de LED_BUILTIN_UPDATE() qui l'a modifié, les masques
+  // set / clear de chaque ligne sont recalculés puis publiés à l'ISR.
+  // L'ISR écrit une ligne en une écriture par registre (W1TS / W1TC).
+  // Canal 1 = LED (ligne 0, colonne 0), canal 2 = (ligne 0, colonne 1), ...
+  // Broches limitées au premier banc GPIO : 0-31 (ESP32), 0-15 (ESP8266).
+  // LED_MATRIX_ROW_ACTIVE_HIGH (défaut 1) / LED_MATRIX_COL_ACTIVE_HIGH
+  // (défaut 0) : niveaux d'une ligne active et d'une colonne allumée.
+  // ------------------------------------------------------------
+  #if defined(LED_BUILTIN_BACKEND_MATRIX)
+    #if !defined(LED_MATRIX_ROWS) || !defined(LED_MATRIX_COLS)
+      #error "LED_BUILTIN_BACKEND_MATRIX requires LED_MATRIX_ROWS and LED_MATRIX_COLS"
+    #endif
+    #define LED_BUILTIN_CFG_BACKEND 2
+    #define LED_SCAN_ROWS LED_MATRIX_ROWS
+    #define LED_SCAN_COLS LED_MATRIX_COLS
   #else
-    digitalWrite(LED_BUILTIN, LED_ON_STATE);
+    #if !defined(LED_CHARLIEPLEX_PINS) || LED_CHARLIEPLEX_PINS < 2
+      #error "LED_BUILTIN_BACKEND_CHARLIEPLEX requires LED_CHARLIEPLEX_PINS >= 2"
+    #endif
+    // Une "ligne" = une broche en anode, les LED de la ligne ont leur
+    // cathode sur chacune des autres broches
+    #define LED_BUILTIN_CFG_BACKEND 3
+    #define LED_SCAN_ROWS LED_CHARLIEPLEX_PINS
+    #define LED_SCAN_COLS (LED_CHARLIEPLEX_PINS - 1)
   #endif
-}
+  #if LED_CHANNEL_COUNT - 1 > LED_SCAN_ROWS * LED_SCAN_COLS
+    #error "LED_CHANNEL_COUNT - 1 exceeds the number of LEDs of the matrix"
+  #endif
+  #ifndef LED_SCAN_REFRESH_HZ
+    #define LED_SCAN_REFRESH_HZ 200
+  #endif
+
+  typedef struct {
+    float refresh_hz;   // trames complètes par seconde depuis la dernière lecture
+    uint32_t isr_count; // interruptions depuis la dernière lecture
+    float isr_avg_us;   // durée moyenne de l'ISR
+    float isr_max_us;   // durée maximale de l'ISR
+    float cpu_load;     // part du temps CPU passée dans l'ISR (%)
+  } LED_ScanStats_t;
 
-void LED_BUILTIN_OFF(void) {
-  #ifdef LED_BUILTIN_IS_RGB
-    LED_RGB_OFF();
+  /**
+   * @brief Arrête le balayage et éteint la matrice
+   */
+  void LED_SCAN_STOP(void);
+
+  #if defined(LED_BUILTIN_BACKEND_MATRIX)
+  /**
+   * @brief Démarre le balayage d'une matrice lignes / colonnes
+   * @param row_pins LED_MATRIX_ROWS broches de ligne
+   * @param col_pins LED_MATRIX_COLS broches de colonne
+   * @param refresh_hz Trames complètes par seconde (défaut : LED_SCAN_REFRESH_HZ)
+   * @return false si une broche est hors du premier banc GPIO, si une ligne
+   *         dure moins de LED_SCAN_MIN_TICKS ou si le timer est indisponible
+   */
+  bool LED_MATRIX_BEGIN(const uint8_t* row_pins, const uint8_t* col_pins, uint16_t refresh_hz = LED_SCAN_REFRESH_HZ);
   #else
-    digitalWrite(LED_BUILTIN, LED_OFF_STATE);
+  /**
+   * @brief Démarre le balayage d'un réseau charlieplexé
+   * @param pins LED_CHARLIEPLEX_PINS broches ; LED (a, k) : anode pins[a],
+   *             cathode pins[k] si k < a, sinon pins[k + 1]
+   * @param refresh_hz Trames complètes par seconde (défaut : LED_SCAN_REFRESH_HZ)
+   * @return false si une broche est hors du premier banc GPIO, si une ligne
+   *         dure moins de LED_SCAN_MIN_TICKS ou si le timer est indisponible
+   */
+  bool LED_CHARLIEPLEX_BEGIN(const uint8_t* pins, uint16_t refresh_hz = LED_SCAN_REFRESH_HZ);
   #endif
-}
 
-void LED_BUILTIN_TOGGLE(void) {
-  #ifdef LED_BUILTIN_IS_RGB
-    // Pour RGB, on alterne entre ON et OFF
-    static bool rgb_state = false;
-    rgb_state = !rgb_state;
-    if(rgb_state) LED_RGB_ON();
-    else LED_RGB_OFF();
-  #else
-    digitalWrite(LED_BUILTIN, !digitalRead(LED_BUILTIN));
+  /**
+   * @brief Lit puis remet à zéro les statistiques de balayage
+   * @param stats Structure remplie
+   */
+  void LED_SCAN_GET_STATS(LED_ScanStats_t* stats);
+
+#elif defined(LED_BUILTIN_BACKEND_BCM)
+  // ------------------------------------------------------------
+  // Gradation par modulation binaire (Binary Code Modulation) sur GPIO
+  // simples. La luminosité de chaque canal (LED_BCM_BITS bits) est
+  // décomposée en plans de bits ; pour chaque plan, loop() précalcule un
+  // masque set et un masque clear couvrant toutes les LED. L'ISR affiche
+  // le plan b pendant 2^b ticks : LED_BCM_BITS interruptions par cycle et
+  // deux écritures de registre par interruption, quel que soit le nombre
+  // de LED. Un canal allumé par blink / pattern prend sa luminosité
+  // (LED_CHANNEL_SET_BRIGHTNESS), éteint il vaut 0.
+  // Broches limitées au premier banc GPIO : 0-31 (ESP32), 0-15 (ESP8266).
+  // LED_BCM_ACTIVE_HIGH : 1 = HIGH allume la LED (défaut).
+  // ------------------------------------------------------------
+  #define LED_BUILTIN_CFG_BACKEND 4
+  #ifndef LED_BCM_BITS
+    #define LED_BCM_BITS 8
+  #endif
+  #if LED_BCM_BITS < 1 || LED_BCM_BITS > 8
+    #error "LED_BCM_BITS must be between 1 and 8"
+  #endif
+  #ifndef LED_BCM_REFRESH_HZ
+    #define LED_BCM_REFRESH_HZ 100
   #endif
+
+  /**
+   * @brief Définit la luminosité d'un canal lorsqu'il est allumé
+   * @param ch Canal (1 à LED_CHANNEL_COUNT-1)
+   * @param level Luminosité 0-255 (seuls les LED_BCM_BITS bits de poids fort sont affichés)
+   * @note 255 par défaut ; peut être appelée avant LED_BCM_BEGIN(), qui conserve le réglage
+   */
+  void LED_CHANNEL_SET_BRIGHTNESS(uint16_t ch, uint8_t level);
+
+  /**
+   * @brief Arrête la modulation et éteint toutes les LED BCM
+   */
+  void LED_BCM_STOP(void);
+
+  /**
+   * @brief Démarre la modulation BCM
+   * @param pins LED_CHANNEL_COUNT-1 broches : pins[0] pour le canal 1, etc.
+   * @param refresh_hz Cycles BCM complets par seconde (défaut : LED_BCM_REFRESH_HZ)
+   * @return false si une broche est hors du premier banc GPIO, si le plan le
+   *         plus court descend sous LED_BCM_MIN_TICKS ou si le timer est indisponible
+   */
+  bool LED_BCM_BEGIN(const uint8_t* pins, uint16_t refresh_hz = LED_BCM_REFRESH_HZ);
+
+#else
+  // ------------------------------------------------------------
+  // GPIO : un canal = une broche, attribuée par LED_CHANNEL_ATTACH()
+  // ------------------------------------------------------------
+  /**
+   * @brief Attribue une broche GPIO à un canal et l'éteint
+   * @param ch Canal (1 à LED_CHANNEL_COUNT-1)
+   * @param pin Numéro de GPIO (0 à 63)
+   * @param active_high true si HIGH allume la LED (défaut)
+   */
+  void LED_CHANNEL_ATTACH(uint16_t ch, uint8_t pin, bool active_high = true);
+#endif
+
+#endif // LED_CHANNEL_COUNT > 1
+
+// ============================================
+// IDENTIFIANT DE CONFIGURATION
+// ============================================
+// Les options qui dimensionnent des tableaux du moteur figurent dans le nom
+// par leur valeur : comme LED_CHANNEL_COUNT, elles doivent être données sous
+// forme de nombre entier (ex. -D LED_MATRIX_ROWS=4), sans expression.
+#ifndef LED_BUILTIN_CFG_BACKEND
+  #define LED_BUILTIN_CFG_BACKEND 0   // GPIO
+#endif
+#if defined(LED_BUILTIN_BACKEND_MATRIX)
+  #define LED_BUILTIN_CFG_DIM_A LED_MATRIX_ROWS
+  #define LED_BUILTIN_CFG_DIM_B LED_MATRIX_COLS
+#elif defined(LED_BUILTIN_BACKEND_CHARLIEPLEX)
+  #define LED_BUILTIN_CFG_DIM_A LED_CHARLIEPLEX_PINS
+  #define LED_BUILTIN_CFG_DIM_B 0
+#elif defined(LED_BUILTIN_BACKEND_BCM)
+  #define LED_BUILTIN_CFG_DIM_A LED_BCM_BITS
+  #define LED_BUILTIN_CFG_DIM_B 0
+#else
+  #define LED_BUILTIN_CFG_DIM_A 0
+  #define LED_BUILTIN_CFG_DIM_B 0
+#endif
+#ifdef LED_BUILTIN_TRACE
+  #define LED_BUILTIN_CFG_TRACE LED_BUILTIN_TRACE_SIZE
+#else
+  #define LED_BUILTIN_CFG_TRACE 0
+#endif
+#ifdef LED_BUILTIN_NO_FLOAT_API
+  #define LED_BUILTIN_CFG_FLOAT 0
+#else
+  #define LED_BUILTIN_CFG_FLOAT 1
+#endif
+#ifdef LED_BUILTIN_NO_PATTERNS
+  #define LED_BUILTIN_CFG_PATTERNS 0
+#else
+  #define LED_BUILTIN_CFG_PATTERNS 1
+#endif
+#ifdef LED_RGB_AVAILABLE
+  #define LED_BUILTIN_CFG_RGB 1
+#else
+  #define LED_BUILTIN_CFG_RGB 0
+#endif
+#ifndef LED_BUILTIN_CFG_CLOCK
+  #define LED_BUILTIN_CFG_CLOCK 1     // LED_BUILTIN_FAST_CLOCK fourni par l'utilisateur
+#endif
+
+#define LED_BUILTIN_CFG_NAME_(n, b, da, db, t, k, f, p, r) \
+  led_builtin_begin_c##n##_b##b##_d##da##x##db##_t##t##_k##k##_f##f##_p##p##_r##r
+#define LED_BUILTIN_CFG_NAME(n, b, da, db, t, k, f, p, r) LED_BUILTIN_CFG_NAME_(n, b, da, db, t, k, f, p, r)
+#define LED_BUILTIN_BEGIN_CONFIGURED \
+  LED_BUILTIN_CFG_NAME(LED_CHANNEL_COUNT, LED_BUILTIN_CFG_BACKEND, \
+                       LED_BUILTIN_CFG_DIM_A, LED_BUILTIN_CFG_DIM_B, \
+                       LED_BUILTIN_CFG_TRACE, LED_BUILTIN_CFG_CLOCK, \
+                       LED_BUILTIN_CFG_FLOAT, LED_BUILTIN_CFG_PATTERNS, LED_BUILTIN_CFG_RGB)
+
+// Initialisation du moteur ; son nom encode la configuration compilée
+void LED_BUILTIN_BEGIN_CONFIGURED(uint8_t pin, uint8_t on_state);
+
+// ============================================
+// FONCTIONS DE BASE
+// ============================================
+/**
+ * @brief Initialise LED_BUILTIN et l'éteint
+ *
+ * Inline : le GPIO et la polarité sont ceux vus par le sketch, ce qui
+ * permet de les surcharger avant l'include sans recompiler la bibliothèque.
+ */
+inline void ENABLE_LED_BUILTIN(void) {
+  LED_BUILTIN_BEGIN_CONFIGURED(LED_BUILTIN, LED_ON_STATE);
 }
 
+void LED_BUILTIN_ON(void);
+void LED_BUILTIN_OFF(void);
+void LED_BUILTIN_TOGGLE(void);
+
+// ============================================
+// CANAUX
+// ============================================
+/**
+ * @brief Allume un canal
+ * @param ch Canal (0 = LED_BUILTIN)
+ */
+void LED_CHANNEL_ON(uint16_t ch);
+
+/**
+ * @brief Éteint un canal
+ * @param ch Canal (0 = LED_BUILTIN)
+ */
+void LED_CHANNEL_OFF(uint16_t ch);
+
+/**
+ * @brief Arrête la séquence en cours sur un canal et l'éteint
+ * @param ch Canal (0 = LED_BUILTIN)
+ */
+void LED_CHANNEL_STOP(uint16_t ch);
+
 /**
  * @brief Arrête toute séquence de clignotement en cours
  */
-void LED_BUILTIN_STOP(void) {
-  led_ctrl.state = LED_STATE_IDLE;
-  LED_BUILTIN_OFF();
-}
+void LED_BUILTIN_STOP(void);
 
 // ============================================
 // FONCTION UPDATE - À APPELER DANS loop()
 // ============================================
 /**
- * @brief Met à jour l'état de la LED (à appeler dans loop())
+ * @brief Chemin lent de LED_BUILTIN_UPDATE() : traite les transitions échues
  * @return true si une animation est en cours, false sinon
  */
-bool LED_BUILTIN_UPDATE(void) {
-  unsigned long current_time = millis();
-  
-  switch(led_ctrl.state) {
-    case LED_STATE_IDLE:
-      return false;
-      
-    case LED_STATE_BLINK:
-      if(current_time >= led_ctrl.next_time) {
-        if(led_ctrl.led_is_on) {
-          // Passer de ON à OFF
-          LED_BUILTIN_OFF();
-          led_ctrl.led_is_on = false;
-          led_ctrl.current_count++;
-          
-          // Vérifier si on a terminé
-          if(led_ctrl.current_count >= led_ctrl.count) {
-            led_ctrl.state = LED_STATE_IDLE;
-            return false;
-          }
-          
-          led_ctrl.next_time = current_time + led_ctrl.off_time;
-        } else {
-          // Passer de OFF à ON
-          LED_BUILTIN_ON();
-          led_ctrl.led_is_on = true;
-          led_ctrl.next_time = current_time + led_ctrl.on_time;
-        }
-      }
-      return true;
-      
-    case LED_STATE_PATTERN:
-      if(current_time >= led_ctrl.next_time) {
-        // État suivant du pattern
-        if(led_ctrl.pattern[led_ctrl.pattern_index] == 1) {
-          LED_BUILTIN_ON();
-        } else {
-          LED_BUILTIN_OFF();
-        }
-        
-        led_ctrl.next_time = current_time + led_ctrl.times[led_ctrl.pattern_index];
-        led_ctrl.pattern_index++;
-        
-        // Fin du pattern ?
-        if(led_ctrl.pattern_index >= led_ctrl.pattern_length) {
-          led_ctrl.pattern_index = 0;
-          led_ctrl.pattern_current_repeat++;
-          
-          if(led_ctrl.pattern_current_repeat >= led_ctrl.pattern_repeat) {
-            LED_BUILTIN_OFF();
-            led_ctrl.state = LED_STATE_IDLE;
-            return false;
-          }
-        }
-      }
-      return true;
-  }
-  
-  return false;
+bool LED_BUILTIN_UPDATE_DUE(void);
+
+/**
+ * @brief Met à jour l'état des LED (à appeler dans loop())
+ *
+ * Toujours inline : au repos ou tant que rien n'est échu, le coût se limite
+ * à une lecture du nombre de canaux actifs, une lecture du compteur de
+ * cycles et deux comparaisons. Le chemin lent n'est appelé qu'à l'échéance.
+ * @return true si une animation est en cours, false sinon
+ */
+static LED_BUILTIN_ALWAYS_INLINE bool LED_BUILTIN_UPDATE(void) {
+  if(led_active_count == 0) return false;
+  if((uint32_t)(LED_BUILTIN_FAST_CLOCK() - led_sched_clock) < led_sched_delta) return true;
+  return LED_BUILTIN_UPDATE_DUE();
+}
+
+/**
+ * @brief Force le recalcul de l'échéance au prochain LED_BUILTIN_UPDATE()
+ *
+ * À appeler après un changement de fréquence CPU (setCpuFrequencyMhz()).
+ */
+inline void LED_BUILTIN_RESCHEDULE(void) {
+  led_sched_delta = 0;
 }
 
 // ============================================
@@ -675,38 +999,45 @@ bool LED_BUILTIN_UPDATE(void) {
 // ============================================
 
 /**
- * @brief Démarre un clignotement simple avec rapport cyclique 50%
- * @param delay_ms Durée d'un demi-cycle (ON ou OFF)
+ * @brief Démarre un clignotement sur un canal avec temps ON et OFF séparés
+ * @param ch Canal (0 = LED_BUILTIN)
+ * @param on_time_ms Temps ON en ms
+ * @param off_time_ms Temps OFF en ms
  * @param count Nombre de cycles (défaut: 1)
  */
-void LED_BUILTIN_BLINK_START(uint16_t delay_ms, uint8_t count = 1) {
-  led_ctrl.state = LED_STATE_BLINK;
-  led_ctrl.on_time = delay_ms;
-  led_ctrl.off_time = delay_ms;
-  led_ctrl.count = count;
-  led_ctrl.current_count = 0;
-  led_ctrl.led_is_on = false;
-  led_ctrl.next_time = millis();
-}
+void LED_CHANNEL_BLINK_START(uint16_t ch, uint16_t on_time_ms, uint16_t off_time_ms, uint8_t count = 1);
 
+#ifndef LED_BUILTIN_NO_PATTERNS
 /**
- * @brief Démarre un clignotement avec période et rapport cyclique personnalisés
- * @param period_ms Période totale en ms
- * @param duty_cycle Rapport cyclique (0.0 à 1.0)
+ * @brief Démarre un motif personnalisé sur un canal
+ * @param ch Canal (0 = LED_BUILTIN)
+ * @param pattern Tableau d'états (1=ON, 0=OFF)
+ * @param times Tableau de durées en ms
+ * @param length Longueur des tableaux
+ * @param repeat Nombre de répétitions (défaut: 1)
+ */
+void LED_CHANNEL_PATTERN_START(uint16_t ch, const uint8_t* pattern, const uint16_t* times, uint8_t length, uint8_t repeat = 1);
+#endif
+
+/**
+ * @brief Vérifie si une animation est en cours sur un canal
+ * @param ch Canal (0 = LED_BUILTIN)
+ */
+bool LED_CHANNEL_IS_ACTIVE(uint16_t ch);
+
+/**
+ * @brief Accès en lecture seule à l'état interne d'un canal (diagnostic)
+ * @param ch Canal (0 = LED_BUILTIN)
+ * @return nullptr si le canal n'existe pas
+ */
+const LED_Control_t* LED_CHANNEL_GET_CONTROL(uint16_t ch);
+
+/**
+ * @brief Démarre un clignotement simple avec rapport cyclique 50%
+ * @param delay_ms Durée d'un demi-cycle (ON ou OFF)
  * @param count Nombre de cycles (défaut: 1)
  */
-void LED_BUILTIN_BLINK_DUTY_START(uint16_t period_ms, float duty_cycle, uint8_t count = 1) {
-  if(duty_cycle < 0.0f) duty_cycle = 0.0f;
-  if(duty_cycle > 1.0f) duty_cycle = 1.0f;
-  
-  led_ctrl.state = LED_STATE_BLINK;
-  led_ctrl.on_time = (uint16_t)(period_ms * duty_cycle);
-  led_ctrl.off_time = period_ms - led_ctrl.on_time;
-  led_ctrl.count = count;
-  led_ctrl.current_count = 0;
-  led_ctrl.led_is_on = false;
-  led_ctrl.next_time = millis();
-}
+void LED_BUILTIN_BLINK_START(uint16_t delay_ms, uint8_t count = 1);
 
 /**
  * @brief Démarre un clignotement avec temps ON et OFF séparés
@@ -714,15 +1045,16 @@ void LED_BUILTIN_BLINK_DUTY_START(uint16_t period_ms, float duty_cycle, uint8_t
  * @param off_time_ms Temps OFF en ms
  * @param count Nombre de cycles (défaut: 1)
  */
-void LED_BUILTIN_BLINK_TIMING_START(uint16_t on_time_ms, uint16_t off_time_ms, uint8_t count = 1) {
-  led_ctrl.state = LED_STATE_BLINK;
-  led_ctrl.on_time = on_time_ms;
-  led_ctrl.off_time = off_time_ms;
-  led_ctrl.count = count;
-  led_ctrl.current_count = 0;
-  led_ctrl.led_is_on = false;
-  led_ctrl.next_time = millis();
-}
+void LED_BUILTIN_BLINK_TIMING_START(uint16_t on_time_ms, uint16_t off_time_ms, uint8_t count = 1);
+
+#ifndef LED_BUILTIN_NO_FLOAT_API
+/**
+ * @brief Démarre un clignotement avec période et rapport cyclique personnalisés
+ * @param period_ms Période totale en ms
+ * @param duty_cycle Rapport cyclique (0.0 à 1.0)
+ * @param count Nombre de cycles (défaut: 1)
+ */
+void LED_BUILTIN_BLINK_DUTY_START(uint16_t period_ms, float duty_cycle, uint8_t count = 1);
 
 /**
  * @brief Démarre un clignotement avec fréquence et rapport cyclique
@@ -730,17 +1062,10 @@ void LED_BUILTIN_BLINK_TIMING_START(uint16_t on_time_ms, uint16_t off_time_ms, u
  * @param duty_cycle Rapport cyclique (0.0 à 1.0)
  * @param duration_ms Durée totale en ms
  */
-void LED_BUILTIN_BLINK_FREQ_START(float freq_hz, float duty_cycle, uint16_t duration_ms) {
-  if(freq_hz <= 0.0f) return;
-  if(duty_cycle < 0.0f) duty_cycle = 0.0f;
-  if(duty_cycle > 1.0f) duty_cycle = 1.0f;
-  
-  uint16_t period_ms = (uint16_t)(1000.0f / freq_hz);
-  uint8_t count = (uint8_t)(duration_ms / period_ms);
-  
-  LED_BUILTIN_BLINK_DUTY_START(period_ms, duty_cycle, count);
-}
+void LED_BUILTIN_BLINK_FREQ_START(float freq_hz, float duty_cycle, uint16_t duration_ms);
+#endif
 
+#ifndef LED_BUILTIN_NO_PATTERNS
 /**
  * @brief Démarre un clignotement avec motif personnalisé
  * @param pattern Tableau d'états (1=ON, 0=OFF)
@@ -748,95 +1073,71 @@ void LED_BUILTIN_BLINK_FREQ_START(float freq_hz, float duty_cycle, uint16_t dura
  * @param length Longueur des tableaux
  * @param repeat Nombre de répétitions (défaut: 1)
  */
-void LED_BUILTIN_BLINK_PATTERN_START(const uint8_t* pattern, const uint16_t* times, uint8_t length, uint8_t repeat = 1) {
-  led_ctrl.state = LED_STATE_PATTERN;
-  led_ctrl.pattern = pattern;
-  led_ctrl.times = times;
-  led_ctrl.pattern_length = length;
-  led_ctrl.pattern_index = 0;
-  led_ctrl.pattern_repeat = repeat;
-  led_ctrl.pattern_current_repeat = 0;
-  led_ctrl.next_time = millis();
-}
+void LED_BUILTIN_BLINK_PATTERN_START(const uint8_t* pattern, const uint16_t* times, uint8_t length, uint8_t repeat = 1);
 
 /**
  * @brief Démarre un signal SOS (signal de détresse)
  */
-void LED_BUILTIN_SOS_START(void) {
-  // Pattern SOS : ...---...
-  static const uint8_t sos_pattern[] = {
-    1,0, 1,0, 1,0,  // S (3 courts)
-    0,              // Pause
-    1,0, 1,0, 1,0,  // O (3 longs)
-    0,              // Pause
-    1,0, 1,0, 1,0   // S (3 courts)
-  };
-  
-  static const uint16_t sos_times[] = {
-    200,200, 200,200, 200,300,  // S
-    300,                        // Pause
-    600,200, 600,200, 600,300,  // O
-    300,                        // Pause
-    200,200, 200,200, 200,1000  // S + pause finale
-  };
-  
-  LED_BUILTIN_BLINK_PATTERN_START(sos_pattern, sos_times, 19, 1);
-}
+void LED_BUILTIN_SOS_START(void);
+#endif
 
 /**
  * @brief Vérifie si une animation est en cours
  * @return true si une animation est active, false sinon
  */
-bool LED_BUILTIN_IS_ACTIVE(void) {
-  return led_ctrl.state != LED_STATE_IDLE;
-}
+bool LED_BUILTIN_IS_ACTIVE(void);
 
 // ============================================
 // COMPATIBILITÉ AVEC L'ANCIENNE VERSION (BLOQUANTE)
 // ============================================
+// Fonctions inline : rien n'est émis si le sketch ne les appelle pas.
 #ifdef LED_BUILTIN_COMPATIBILITY_MODE
 
-void LED_BUILTIN_BLINK(uint16_t delay_ms, uint8_t count = 1) {
+inline void LED_BUILTIN_BLINK(uint16_t delay_ms, uint8_t count = 1) {
   LED_BUILTIN_BLINK_START(delay_ms, count);
-  while(LED_BUILTIN_UPDATE()) {
+  while(LED_BUILTIN_UPDATE() && LED_BUILTIN_IS_ACTIVE()) {
     yield(); // Permet au système de traiter d'autres tâches
   }
 }
 
-void LED_BUILTIN_BLINK_DUTY(uint16_t period_ms, float duty_cycle, uint8_t count = 1) {
-  LED_BUILTIN_BLINK_DUTY_START(period_ms, duty_cycle, count);
-  while(LED_BUILTIN_UPDATE()) {
+inline void LED_BUILTIN_BLINK_TIMING(uint16_t on_time_ms, uint16_t off_time_ms, uint8_t count = 1) {
+  LED_BUILTIN_BLINK_TIMING_START(on_time_ms, off_time_ms, count);
+  while(LED_BUILTIN_UPDATE() && LED_BUILTIN_IS_ACTIVE()) {
     yield();
   }
 }
 
-void LED_BUILTIN_BLINK_TIMING(uint16_t on_time_ms, uint16_t off_time_ms, uint8_t count = 1) {
-  LED_BUILTIN_BLINK_TIMING_START(on_time_ms, off_time_ms, count);
-  while(LED_BUILTIN_UPDATE()) {
+#ifndef LED_BUILTIN_NO_FLOAT_API
+inline void LED_BUILTIN_BLINK_DUTY(uint16_t period_ms, float duty_cycle, uint8_t count = 1) {
+  LED_BUILTIN_BLINK_DUTY_START(period_ms, duty_cycle, count);
+  while(LED_BUILTIN_UPDATE() && LED_BUILTIN_IS_ACTIVE()) {
     yield();
   }
 }
 
-void LED_BUILTIN_BLINK_FREQ(float freq_hz, float duty_cycle, uint16_t duration_ms) {
+inline void LED_BUILTIN_BLINK_FREQ(float freq_hz, float duty_cycle, uint16_t duration_ms) {
   LED_BUILTIN_BLINK_FREQ_START(freq_hz, duty_cycle, duration_ms);
-  while(LED_BUILTIN_UPDATE()) {
+  while(LED_BUILTIN_UPDATE() && LED_BUILTIN_IS_ACTIVE()) {
     yield();
   }
 }
+#endif
 
-void LED_BUILTIN_BLINK_PATTERN(const uint8_t* pattern, const uint16_t* times, uint8_t length, uint8_t repeat = 1) {
+#ifndef LED_BUILTIN_NO_PATTERNS
+inline void LED_BUILTIN_BLINK_PATTERN(const uint8_t* pattern, const uint16_t* times, uint8_t length, uint8_t repeat = 1) {
   LED_BUILTIN_BLINK_PATTERN_START(pattern, times, length, repeat);
-  while(LED_BUILTIN_UPDATE()) {
+  while(LED_BUILTIN_UPDATE() && LED_BUILTIN_IS_ACTIVE()) {
     yield();
   }
 }
 
-void LED_BUILTIN_SOS(void) {
+inline void LED_BUILTIN_SOS(void) {
   LED_BUILTIN_SOS_START();
-  while(LED_BUILTIN_UPDATE()) {
+  while(LED_BUILTIN_UPDATE() && LED_BUILTIN_IS_ACTIVE()) {
     yield();
   }
 }
+#endif
 
 #endif // LED_BUILTIN_COMPATIBILITY_MODE
 #endif // LED_BUILTIN_H
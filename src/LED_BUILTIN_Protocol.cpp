@@ -0,0 +1,313 @@
+//  --------------------------------------------------------------------------
+//  LED_BUILTIN_Protocol.cpp  –  Parseur incrémental du protocole série
+//  --------------------------------------------------------------------------
+
+#include "LED_BUILTIN_Protocol.h"
+
+// ============================================
+// ÉTAT DU PARSEUR
+// ============================================
+typedef enum {
+  LED_PROTO_WAIT_SYNC,
+  LED_PROTO_WAIT_LEN,
+  LED_PROTO_WAIT_BODY,   // SEQ, CMD puis PAYLOAD
+  LED_PROTO_WAIT_CRC
+} LED_ProtoState_t;
+
+static LED_ProtoState_t led_proto_state = LED_PROTO_WAIT_SYNC;
+static uint8_t led_proto_len = 0;
+static uint8_t led_proto_pos = 0;
+static uint8_t led_proto_crc = 0;
+static uint8_t led_proto_rx[2 + LED_PROTO_MAX_PAYLOAD];   // SEQ, CMD, PAYLOAD
+
+// Réponse la plus longue : STATS (statut + 5 × u32)
+#define LED_PROTO_MAX_REPLY 21
+static uint8_t led_proto_tx[5 + LED_PROTO_MAX_REPLY];     // SYNC, LEN, SEQ, CMD, données, CRC
+static uint8_t led_proto_tx_len = 0;
+static uint8_t led_proto_tx_pos = 0;
+static bool led_proto_tx_room_seen = false;   // availableForWrite() a déjà retourné > 0
+
+static LED_ProtoStats_t led_proto_stats;
+
+// ============================================
+// SLOTS DE MOTIFS
+// ============================================
+#ifndef LED_BUILTIN_NO_PATTERNS
+  typedef struct {
+    uint8_t levels[LED_PROTO_SLOT_STEPS];
+    uint16_t times[LED_PROTO_SLOT_STEPS];
+    uint8_t length;                         // 0 = slot vide
+  } LED_ProtoSlot_t;
+
+  static LED_ProtoSlot_t led_proto_slots[LED_PROTO_SLOTS];
+#endif
+
+// ============================================
+// OUTILS
+// ============================================
+static uint8_t led_proto_crc8(uint8_t crc, uint8_t data) {
+  crc ^= data;
+  for(uint8_t bit = 0; bit < 8; bit++) {
+    crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+  }
+  return crc;
+}
+
+static inline uint16_t led_proto_u16(const uint8_t* p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint8_t* led_proto_put_u16(uint8_t* p, uint16_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+  return p + 2;
+}
+
+static inline uint8_t* led_proto_put_u32(uint8_t* p, uint32_t v) {
+  p = led_proto_put_u16(p, (uint16_t)v);
+  return led_proto_put_u16(p, (uint16_t)(v >> 16));
+}
+
+// Encadre les données déjà écrites à partir de led_proto_tx[4]
+static void led_proto_reply(uint8_t seq, uint8_t cmd, uint8_t len) {
+  led_proto_tx[0] = LED_PROTO_SYNC;
+  led_proto_tx[1] = len;
+  led_proto_tx[2] = seq;
+  led_proto_tx[3] = cmd | LED_PROTO_REPLY;
+  uint8_t crc = 0;
+  for(uint8_t i = 1; i < 4 + len; i++) {
+    crc = led_proto_crc8(crc, led_proto_tx[i]);
+  }
+  led_proto_tx[4 + len] = crc;
+  led_proto_tx_len = 5 + len;
+  led_proto_tx_pos = 0;
+}
+
+// Émet la réponse en attente sans jamais bloquer
+static bool led_proto_flush(Stream& port) {
+  if(led_proto_tx_pos >= led_proto_tx_len) return true;
+  int room = port.availableForWrite();
+  if(room > 0) led_proto_tx_room_seen = true;
+  // Print::availableForWrite() retourne 0 si le Stream ne l'implémente pas :
+  // tant qu'aucune place n'a été annoncée, écriture par petits blocs
+  else if(!led_proto_tx_room_seen) room = LED_PROTO_TX_BLIND_CHUNK;
+  if(room <= 0) return false;
+  uint8_t n = led_proto_tx_len - led_proto_tx_pos;
+  if(n > room) n = (uint8_t)room;
+  led_proto_tx_pos += (uint8_t)port.write(&led_proto_tx[led_proto_tx_pos], n);
+  return led_proto_tx_pos >= led_proto_tx_len;
+}
+
+// ============================================
+// COMMANDES
+// ============================================
+// Exécute la trame reçue et prépare la réponse ; retourne sa longueur
+static uint8_t led_proto_execute(uint8_t cmd, const uint8_t* p, uint8_t len) {
+  uint8_t* out = &led_proto_tx[4];
+  out[0] = LED_PROTO_OK;
+
+  switch(cmd) {
+    case LED_PROTO_CMD_PING: {
+      uint8_t* q = out + 1;
+      *q++ = LED_PROTO_VERSION;
+      q = led_proto_put_u16(q, LED_CHANNEL_COUNT);
+    #ifndef LED_BUILTIN_NO_PATTERNS
+      *q++ = LED_PROTO_SLOTS;
+      *q++ = LED_PROTO_SLOT_STEPS;
+    #else
+      // Motifs absents de ce build : UPLOAD et PATTERN sont refusés
+      *q++ = 0;
+      *q++ = 0;
+    #endif
+      return (uint8_t)(q - out);
+    }
+
+    case LED_PROTO_CMD_STOP: {
+      if(len != 2) break;
+      uint16_t ch = led_proto_u16(p);
+      if(ch == LED_PROTO_ALL_CHANNELS) {
+        for(uint16_t c = 0; c < LED_CHANNEL_COUNT; c++) {
+          if(LED_CHANNEL_IS_ACTIVE(c)) LED_CHANNEL_STOP(c);
+        }
+      } else if(ch < LED_CHANNEL_COUNT) {
+        LED_CHANNEL_STOP(ch);
+      } else {
+        out[0] = LED_PROTO_BAD_CHANNEL;
+      }
+      return 1;
+    }
+
+    case LED_PROTO_CMD_BLINK: {
+      if(len != 7) break;
+      uint16_t ch = led_proto_u16(p);
+      if(ch >= LED_CHANNEL_COUNT) {
+        out[0] = LED_PROTO_BAD_CHANNEL;
+        return 1;
+      }
+      LED_CHANNEL_BLINK_START(ch, led_proto_u16(p + 2), led_proto_u16(p + 4), p[6]);
+      return 1;
+    }
+
+  #ifndef LED_BUILTIN_NO_PATTERNS
+    case LED_PROTO_CMD_UPLOAD: {
+      // Au moins un pas, et un nombre entier de pas
+      if(len < 3 || (len & 1) == 0 || (len - 1) / 2 > LED_PROTO_SLOT_STEPS) break;
+      if(p[0] >= LED_PROTO_SLOTS) {
+        out[0] = LED_PROTO_BAD_SLOT;
+        return 1;
+      }
+      LED_ProtoSlot_t* slot = &led_proto_slots[p[0]];
+      uint8_t steps = (len - 1) / 2;
+      for(uint8_t i = 0; i < steps; i++) {
+        uint16_t step = led_proto_u16(p + 1 + 2 * i);
+        slot->levels[i] = (uint8_t)(step >> 15);
+        slot->times[i] = step & 0x7FFF;
+      }
+      slot->length = steps;
+      // Les canaux qui jouaient l'ancienne version gardent sa longueur et son
+      // index : ils repartent du premier pas de la nouvelle, avec les
+      // répétitions qu'il leur restait
+      for(uint16_t ch = 0; ch < LED_CHANNEL_COUNT; ch++) {
+        const LED_Control_t* c = LED_CHANNEL_GET_CONTROL(ch);
+        if(c->state != LED_STATE_PATTERN || c->pattern != slot->levels) continue;
+        uint8_t left = c->pattern_repeat > c->pattern_current_repeat
+                     ? c->pattern_repeat - c->pattern_current_repeat : 1;
+        LED_CHANNEL_PATTERN_START(ch, slot->levels, slot->times, steps, left);
+      }
+      return 1;
+    }
+
+    case LED_PROTO_CMD_PATTERN: {
+      if(len != 4) break;
+      uint16_t ch = led_proto_u16(p);
+      if(ch >= LED_CHANNEL_COUNT) {
+        out[0] = LED_PROTO_BAD_CHANNEL;
+        return 1;
+      }
+      if(p[2] >= LED_PROTO_SLOTS || led_proto_slots[p[2]].length == 0) {
+        out[0] = LED_PROTO_BAD_SLOT;
+        return 1;
+      }
+      LED_ProtoSlot_t* slot = &led_proto_slots[p[2]];
+      LED_CHANNEL_PATTERN_START(ch, slot->levels, slot->times, slot->length, p[3]);
+      return 1;
+    }
+  #endif
+
+    case LED_PROTO_CMD_STATE: {
+      if(len != 2) break;
+      const LED_Control_t* c = LED_CHANNEL_GET_CONTROL(led_proto_u16(p));
+      if(c == nullptr) {
+        out[0] = LED_PROTO_BAD_CHANNEL;
+        return 1;
+      }
+      uint8_t level = c->led_is_on ? 1 : 0;
+      uint8_t step = c->current_count;
+      uint8_t repeats = 0;
+    #ifndef LED_BUILTIN_NO_PATTERNS
+      if(c->state == LED_STATE_PATTERN) {
+        // Niveau écrit par le dernier pas exécuté (aucun avant le premier)
+        step = c->pattern_index;
+        repeats = c->pattern_current_repeat;
+        if(step > 0) level = c->pattern[step - 1] == 1;
+        else level = repeats > 0 && c->pattern[c->pattern_length - 1] == 1;
+      }
+    #endif
+      long remaining = (long)(c->next_time - millis());
+      uint8_t* q = led_proto_put_u16(out + 1, led_active_count);
+      *q++ = (uint8_t)c->state;
+      *q++ = level;
+      *q++ = step;
+      *q++ = repeats;
+      q = led_proto_put_u32(q, (c->state != LED_STATE_IDLE && remaining > 0) ? (uint32_t)remaining : 0);
+      return (uint8_t)(q - out);
+    }
+
+    case LED_PROTO_CMD_STATS: {
+      uint8_t* q = led_proto_put_u32(out + 1, led_proto_stats.frames);
+      q = led_proto_put_u32(q, led_proto_stats.crc_errors);
+      q = led_proto_put_u32(q, led_proto_stats.bad_frames);
+      q = led_proto_put_u32(q, led_proto_stats.tx_stalls);
+      q = led_proto_put_u32(q, led_proto_stats.poll_max_us);
+      return (uint8_t)(q - out);
+    }
+
+    default:
+      out[0] = LED_PROTO_UNKNOWN_CMD;
+      return 1;
+  }
+
+  out[0] = LED_PROTO_BAD_LENGTH;
+  return 1;
+}
+
+// ============================================
+// POLL
+// ============================================
+bool LED_PROTO_POLL(Stream& port, uint16_t budget_us) {
+  uint32_t start = micros();
+  bool executed = false;
+
+  if(!led_proto_flush(port)) {
+    led_proto_stats.tx_stalls++;
+    return false;
+  }
+
+  // Une réponse non émise en entier suspend la lecture des trames suivantes
+  while(led_proto_tx_pos >= led_proto_tx_len &&
+        (uint32_t)(micros() - start) < budget_us && port.available() > 0) {
+    uint8_t b = (uint8_t)port.read();
+
+    switch(led_proto_state) {
+      case LED_PROTO_WAIT_SYNC:
+        if(b == LED_PROTO_SYNC) led_proto_state = LED_PROTO_WAIT_LEN;
+        break;
+
+      case LED_PROTO_WAIT_LEN:
+        if(b > LED_PROTO_MAX_PAYLOAD) {
+          led_proto_stats.bad_frames++;
+          // L'octet peut être lui-même un début de trame
+          led_proto_state = (b == LED_PROTO_SYNC) ? LED_PROTO_WAIT_LEN : LED_PROTO_WAIT_SYNC;
+          break;
+        }
+        led_proto_len = b;
+        led_proto_pos = 0;
+        led_proto_crc = led_proto_crc8(0, b);
+        led_proto_state = LED_PROTO_WAIT_BODY;
+        break;
+
+      case LED_PROTO_WAIT_BODY:
+        led_proto_rx[led_proto_pos++] = b;
+        led_proto_crc = led_proto_crc8(led_proto_crc, b);
+        if(led_proto_pos >= 2 + led_proto_len) led_proto_state = LED_PROTO_WAIT_CRC;
+        break;
+
+      case LED_PROTO_WAIT_CRC:
+        led_proto_state = LED_PROTO_WAIT_SYNC;
+        if(b != led_proto_crc) {
+          led_proto_stats.crc_errors++;
+          break;
+        }
+        led_proto_stats.frames++;
+        executed = true;
+        led_proto_reply(led_proto_rx[0], led_proto_rx[1],
+                        led_proto_execute(led_proto_rx[1], &led_proto_rx[2], led_proto_len));
+        led_proto_flush(port);
+        break;
+    }
+  }
+
+  uint32_t elapsed = micros() - start;
+  if(elapsed > led_proto_stats.poll_max_us) led_proto_stats.poll_max_us = elapsed;
+  return executed;
+}
+
+void LED_PROTO_GET_STATS(LED_ProtoStats_t* stats) {
+  *stats = led_proto_stats;
+}
+
+void LED_PROTO_RESET(void) {
+  led_proto_state = LED_PROTO_WAIT_SYNC;
+  led_proto_tx_len = 0;
+  led_proto_tx_pos = 0;
+}
@@ -0,0 +1,110 @@
+//  --------------------------------------------------------------------------
+//  LED_BUILTIN_Protocol.h  –  Protocole série binaire de pilotage du moteur
+//  --------------------------------------------------------------------------
+//  ☞  APPELER  LED_PROTO_POLL(Serial)  DANS  loop() , À CÔTÉ DE
+//     LED_BUILTIN_UPDATE()
+//  --------------------------------------------------------------------------
+//  Trame (hôte → carte) :
+//    0xA5 | LEN | SEQ | CMD | PAYLOAD (LEN octets) | CRC8
+//  Réponse (carte → hôte) :
+//    0xA5 | LEN | SEQ | CMD|0x80 | STATUS, DONNÉES (LEN octets) | CRC8
+//  CRC8 : polynôme 0x07, valeur initiale 0, calculé de LEN au dernier octet
+//  de PAYLOAD. Entiers en little-endian. Une trame invalide (CRC, LEN) est
+//  ignorée et le parseur se resynchronise sur l'octet 0xA5 suivant.
+//
+//  Commandes :
+//    0x01 PING     —                                  → version, canaux (u16), slots, pas par slot (0, 0 sans motifs)
+//    0x02 STOP     canal (u16, 0xFFFF = tous)
+//    0x03 BLINK    canal (u16), on_ms (u16), off_ms (u16), cycles (u8)
+//    0x04 UPLOAD   slot (u8), pas (u16 × n) : bit 15 = niveau, bits 0-14 = durée ms
+//                  (les canaux qui jouent le slot repartent du premier pas)
+//    0x05 PATTERN  canal (u16), slot (u8), répétitions (u8)
+//    0x06 STATE    canal (u16)                        → voir LED_PROTO_CMD_STATE
+//    0x07 STATS    —                                  → voir LED_PROTO_CMD_STATS
+//
+//  Aucune allocation : le parseur, la réponse en attente et les slots de
+//  motifs sont statiques. Voir extras/led_proto.py pour le côté hôte.
+//  --------------------------------------------------------------------------
+
+#ifndef LED_BUILTIN_PROTOCOL_H
+#define LED_BUILTIN_PROTOCOL_H
+#include "LED_BUILTIN.h"
+
+// ----------------------------------------------------------
+// Configuration (build_flags ou LED_BUILTIN_config.h)
+// ----------------------------------------------------------
+#ifndef LED_PROTO_SLOTS
+  #define LED_PROTO_SLOTS 4           // nombre de motifs téléversables
+#endif
+#ifndef LED_PROTO_SLOT_STEPS
+  #define LED_PROTO_SLOT_STEPS 32     // pas maximum par motif
+#endif
+#if LED_PROTO_SLOT_STEPS < 1 || LED_PROTO_SLOT_STEPS > 127
+  #error "LED_PROTO_SLOT_STEPS must be between 1 and 127"
+#endif
+#ifndef LED_PROTO_BUDGET_US
+  #define LED_PROTO_BUDGET_US 200     // temps maximum passé dans LED_PROTO_POLL()
+#endif
+// Octets écrits par poll sur un port qui n'a jamais annoncé de place libre
+// (availableForWrite() non implémenté, retourne toujours 0) ; 0 = jamais
+#ifndef LED_PROTO_TX_BLIND_CHUNK
+  #define LED_PROTO_TX_BLIND_CHUNK 8
+#endif
+
+#define LED_PROTO_VERSION      1
+#define LED_PROTO_SYNC         0xA5
+#define LED_PROTO_MAX_PAYLOAD  (1 + 2 * LED_PROTO_SLOT_STEPS)
+#define LED_PROTO_ALL_CHANNELS 0xFFFF
+
+// Commandes
+#define LED_PROTO_CMD_PING     0x01
+#define LED_PROTO_CMD_STOP     0x02
+#define LED_PROTO_CMD_BLINK    0x03
+#define LED_PROTO_CMD_UPLOAD   0x04
+#define LED_PROTO_CMD_PATTERN  0x05
+#define LED_PROTO_CMD_STATE    0x06   // → canaux actifs (u16), état, niveau, pas, répétitions faites, ms avant transition (u32)
+#define LED_PROTO_CMD_STATS    0x07   // → trames, erreurs CRC, trames rejetées, réponses retardées, durée max du poll en µs (u32 × 5)
+#define LED_PROTO_REPLY        0x80
+
+// Statuts de réponse
+#define LED_PROTO_OK           0x00
+#define LED_PROTO_BAD_LENGTH   0x01
+#define LED_PROTO_BAD_CHANNEL  0x02
+#define LED_PROTO_BAD_SLOT     0x03
+#define LED_PROTO_UNKNOWN_CMD  0x04
+
+typedef struct {
+  uint32_t frames;        // trames valides traitées
+  uint32_t crc_errors;    // trames rejetées sur CRC
+  uint32_t bad_frames;    // trames rejetées sur LEN
+  uint32_t tx_stalls;     // polls retardés par une réponse encore en attente d'émission
+  uint32_t poll_max_us;   // durée maximale d'un LED_PROTO_POLL()
+} LED_ProtoStats_t;
+
+/**
+ * @brief Traite les octets reçus dans la limite d'un budget de temps
+ * @param port Flux série (Serial, ...)
+ * @param budget_us Temps maximum de lecture (défaut : LED_PROTO_BUDGET_US)
+ * @return true si au moins une trame a été exécutée
+ *
+ * Non bloquant : une trame peut arriver en plusieurs appels. La réponse
+ * n'est émise que dans la place libre du tampon d'émission
+ * (availableForWrite()) ; tant qu'elle n'est pas partie, aucune nouvelle
+ * trame n'est lue. Le transport doit implémenter availableForWrite() :
+ * sur un port qui n'a jamais annoncé de place, la réponse part par blocs
+ * de LED_PROTO_TX_BLIND_CHUNK octets, dont l'écriture peut bloquer.
+ */
+bool LED_PROTO_POLL(Stream& port, uint16_t budget_us = LED_PROTO_BUDGET_US);
+
+/**
+ * @brief Copie les statistiques du protocole
+ * @param stats Structure remplie
+ */
+void LED_PROTO_GET_STATS(LED_ProtoStats_t* stats);
+
+/**
+ * @brief Remet le parseur à zéro (trame partielle et réponse en attente perdues)
+ */
+void LED_PROTO_RESET(void);
+
+#endif // LED_BUILTIN_PROTOCOL_H